@@ -61,11 +61,16 @@ public class MiVRy : ModuleRules
 			new string[]
 			{
 				"CoreUObject",
-				"Engine"
+				"Engine",
+				"AssetRegistry"
 			}
 			);
 		
 		
+		if (Target.bBuildEditor) {
+			PrivateDependencyModuleNames.Add("DirectoryWatcher");
+		}
+
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
@@ -21,7 +21,10 @@
 #include "Misc/Paths.h"
 #include "GestureRecognition.h"
 #include "GestureCombinations.h"
+#include "MiVRyGestureDatabase.h"
+#include "MiVRyGestureNameCache.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
@@ -36,78 +39,26 @@ UBTComposite_MiVRy::UBTComposite_MiVRy(const FObjectInitializer& ObjectInitializ
 #if ENGINE_MAJOR_VERSION >= 5
 	INIT_COMPOSITE_NODE_NOTIFY_FLAGS();
 #endif
-	this->bUseNodeActivationNotify = 1;
-	this->Delegate.BindUFunction(this, "OnGestureIdentified");
-	if (this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
-}
-
-void UBTComposite_MiVRy::PostLoad()
-{
-	Super::PostLoad();
-	if (!this->BoundMiVRyActor.IsValid() && this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
-}
-
-#if WITH_EDITOR
-void UBTComposite_MiVRy::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
-{
-	if (PropertyChangedEvent.Property == nullptr) {
-		return;
-	}
-	FName PropertyName = PropertyChangedEvent.Property->GetFName();
-	if (PropertyName != GET_MEMBER_NAME_CHECKED(UBTComposite_MiVRy, MiVRyActor)) {
-		Super::PostEditChangeProperty(PropertyChangedEvent);
-		return;
-	} // else:
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
-		}
-		this->BoundMiVRyActor = nullptr;
-	}
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-	if (this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
-}
-#endif
-
-void UBTComposite_MiVRy::NotifyNodeActivation(FBehaviorTreeSearchData& SearchData) const
-{
-	if (!this->BoundMiVRyActor.IsValid() && this->MiVRyActor.IsValid()) {
-		UBTComposite_MiVRy* me = (UBTComposite_MiVRy*)this;
-		me->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		me->BoundMiVRyActor = this->MiVRyActor;
-	}
 }
 
-UBTComposite_MiVRy::~UBTComposite_MiVRy()
+void UBTComposite_MiVRy::InitializeFromAsset(UBehaviorTree& Asset)
 {
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
+	Super::InitializeFromAsset(Asset);
+	this->HasLatestGestureBlackboardKeys = false;
+	const UBlackboardData* BlackboardAsset = this->GetBlackboardAsset();
+	for (int32 i = 0; i < UBTComposite_MiVRy_NumLatestGestureData; i++) {
+		this->LatestGestureBlackboardKeyIds[i] = FBlackboard::InvalidKey;
+		const FBlackboardKeySelector* Key = this->LatestGestureBlackboardKeys.Find((UBTComposite_MiVRy_LatestGestureData)i);
+		if (Key == nullptr || BlackboardAsset == nullptr) {
+			continue;
 		}
-		this->BoundMiVRyActor = nullptr;
-	}
-	this->Delegate.Clear();
-}
-
-void UBTComposite_MiVRy::BeginDestroy()
-{
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
+		this->LatestGestureBlackboardKeyIds[i] = BlackboardAsset->GetKeyID(Key->SelectedKeyName);
+		if (this->LatestGestureBlackboardKeyIds[i] == FBlackboard::InvalidKey) {
+			UE_LOG(LogTemp, Warning, TEXT("UBTComposite_MiVRy::InitializeFromAsset: Blackboard key '%s' not found."), *Key->SelectedKeyName.ToString());
+			continue;
 		}
-		this->BoundMiVRyActor = nullptr;
+		this->HasLatestGestureBlackboardKeys = true;
 	}
-	this->Delegate.Clear();
-	Super::BeginDestroy();
 }
 
 uint16 UBTComposite_MiVRy::GetInstanceMemorySize() const
@@ -126,6 +77,7 @@ void UBTComposite_MiVRy::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uin
 	if (InitType == EBTMemoryInit::Initialize)
 	{
 		Memory->LatestGestureCounter = 0;
+		Memory->LatestGestureId = -1;
 	}
 }
 
@@ -157,14 +109,26 @@ int32 UBTComposite_MiVRy::GetNextChildHandler(FBehaviorTreeSearchData& SearchDat
 		return BTSpecialChild::ReturnToParent;
 	}
 	// else:
-	if (this->LatestGestureId >= 0) { // valid gesture ID
-		this->SetLatestGestureBlackboardVars(SearchData.OwnerComp.GetBlackboardComponent());
-		if (this->GestureChildMapping.Contains(this->LatestGestureId) == false) {
+	// Consume the latest gesture event of the MiVRy actor (if any new).
+	bool NewGesture = false;
+	const AMiVRyActor* Actor = this->MiVRyActor.Get();
+	if (Actor != nullptr && Memory->LatestGestureCounter != Actor->getGestureEventCounter()) {
+		NewGesture = true;
+		Memory->LatestGestureCounter = Actor->getGestureEventCounter();
+		const AMiVRyActor::GestureEvent* Event = Actor->getGestureEvent(Memory->LatestGestureCounter);
+		if (Event != nullptr && Event->gesture_id >= 0 && Event->similarity >= this->SimilarityThreshold) {
+			Memory->LatestGestureId = Event->gesture_id;
+			this->SetLatestGestureBlackboardVars(SearchData.OwnerComp.GetBlackboardComponent(), *Actor, *Event);
+		} else {
+			Memory->LatestGestureId = -1;
+		}
+	}
+	if (Memory->LatestGestureId >= 0) { // valid gesture ID
+		if (this->GestureChildMapping.Contains(Memory->LatestGestureId) == false) {
 			return BTSpecialChild::ReturnToParent;
 		}
-		const int32 NextChild = this->GestureChildMapping[this->LatestGestureId];
-		if (Memory->LatestGestureCounter != this->LatestGestureCounter) {
-			Memory->LatestGestureCounter = this->LatestGestureCounter;
+		const int32 NextChild = this->GestureChildMapping[Memory->LatestGestureId];
+		if (NewGesture) {
 			return NextChild;
 		}
 		// else: already executed
@@ -181,8 +145,7 @@ int32 UBTComposite_MiVRy::GetNextChildHandler(FBehaviorTreeSearchData& SearchDat
 	if (this->GestureChildMapping.Contains(-1) == false) {
 		return BTSpecialChild::ReturnToParent;
 	}
-	if (Memory->LatestGestureCounter != this->LatestGestureCounter) {
-		Memory->LatestGestureCounter = this->LatestGestureCounter;
+	if (NewGesture) {
 		return this->GestureChildMapping[-1];
 	}
 	// else: already executed
@@ -193,103 +156,57 @@ int32 UBTComposite_MiVRy::GetNextChildHandler(FBehaviorTreeSearchData& SearchDat
 	return BTSpecialChild::ReturnToParent;
 }
 
-void UBTComposite_MiVRy::OnGestureIdentified(
-	AMiVRyActor* Source,
-	GestureRecognition_Identification Result,
-	int GestureID,
-	FString GestureName,
-	float Similarity,
-	const TArray<FMiVRyGesturePart>& GestureParts
-)
+/**
+* Set a blackboard value by key ID, if the key is set.
+* The blackboard only notifies observers of values that actually changed.
+*/
+template<typename TDataClass>
+static void SetBlackboardValue(UBlackboardComponent* BlackboardComponent, FBlackboard::FKey KeyId, typename TDataClass::FDataType Value)
 {
-	if (GestureID >= 0 && Similarity >= this->SimilarityThreshold) {
-		this->LatestGestureId = GestureID;
-		this->LatestGestureName = GestureName;
-		this->LatestGestureSimilarity = Similarity;
-		this->LatestGestureParts = GestureParts;
-	} else {
-		this->LatestGestureId = -1;
+	if (KeyId != FBlackboard::InvalidKey) {
+		BlackboardComponent->SetValue<TDataClass>(KeyId, Value);
 	}
-	this->LatestGestureCounter += 1;
 }
 
-void UBTComposite_MiVRy::SetLatestGestureBlackboardVars(UBlackboardComponent* BlackboardComponent) const
+void UBTComposite_MiVRy::SetLatestGestureBlackboardVars(UBlackboardComponent* BlackboardComponent, const AMiVRyActor& Actor, const AMiVRyActor::GestureEvent& Event) const
 {
-	if (this->LatestGestureBlackboardKeys.Num() <= 0) {
+	if (!this->HasLatestGestureBlackboardKeys) {
 		return;
 	}
 	if (BlackboardComponent == nullptr) {
 		UE_LOG(LogTemp, Warning, TEXT("UBTComposite_MiVRy::SetLatestGestureBlackboardVars: BlackboardComponent not set."));
+		return;
 	}
-	if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::GestureId)) {
-		const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::GestureId];
-		BlackboardComponent->SetValue<UBlackboardKeyType_Int>(Key.SelectedKeyName, this->LatestGestureId);
-	}
-	if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::GestureName)) {
-		const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::GestureName];
-		BlackboardComponent->SetValue<UBlackboardKeyType_String>(Key.SelectedKeyName, this->LatestGestureName);
+	const FBlackboard::FKey* Keys = this->LatestGestureBlackboardKeyIds;
+	SetBlackboardValue<UBlackboardKeyType_Int>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::GestureId], Event.gesture_id);
+	if (Keys[(int32)UBTComposite_MiVRy_LatestGestureData::GestureName] != FBlackboard::InvalidKey) {
+		SetBlackboardValue<UBlackboardKeyType_String>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::GestureName], Actor.getCachedGestureName(Event.gesture_id));
 	}
 	const FMiVRyGesturePart* LeftGesturePart = nullptr;
 	const FMiVRyGesturePart* RightGesturePart = nullptr;
-	for (int i = this->LatestGestureParts.Num() - 1; i >= 0; i--) {
-		const FMiVRyGesturePart* GesturePart = &this->LatestGestureParts[i];
+	for (int i = Event.parts.Num() - 1; i >= 0; i--) {
+		const FMiVRyGesturePart* GesturePart = &Event.parts[i];
 		if (GesturePart->Side == GestureRecognition_Side::Left) {
 			LeftGesturePart = GesturePart;
 		} else if (GesturePart->Side == GestureRecognition_Side::Right) {
 			RightGesturePart = GesturePart;
 		}
 	}
-	if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftPerformed)) {
-		const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftPerformed];
-		BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(Key.SelectedKeyName, LeftGesturePart != nullptr);
-	}
+	SetBlackboardValue<UBlackboardKeyType_Bool>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftPerformed], LeftGesturePart != nullptr);
 	if (LeftGesturePart != nullptr) {
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftPosition)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftPosition];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, LeftGesturePart->Position);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftRotation)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftRotation];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Rotator>(Key.SelectedKeyName, LeftGesturePart->Rotation);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftScale)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftScale];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Float>(Key.SelectedKeyName, LeftGesturePart->Scale);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftPrimaryDirection)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftPrimaryDirection];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, LeftGesturePart->PrimaryDirection);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::LeftSecondaryDirection)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::LeftSecondaryDirection];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, LeftGesturePart->SecondaryDirection);
-		}
-	}
-	if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightPerformed)) {
-		const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightPerformed];
-		BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(Key.SelectedKeyName, RightGesturePart != nullptr);
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftPosition], LeftGesturePart->Position);
+		SetBlackboardValue<UBlackboardKeyType_Rotator>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftRotation], LeftGesturePart->Rotation);
+		SetBlackboardValue<UBlackboardKeyType_Float>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftScale], LeftGesturePart->Scale);
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftPrimaryDirection], LeftGesturePart->PrimaryDirection);
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::LeftSecondaryDirection], LeftGesturePart->SecondaryDirection);
 	}
+	SetBlackboardValue<UBlackboardKeyType_Bool>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightPerformed], RightGesturePart != nullptr);
 	if (RightGesturePart != nullptr) {
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightPosition)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightPosition];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, RightGesturePart->Position);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightRotation)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightRotation];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Rotator>(Key.SelectedKeyName, RightGesturePart->Rotation);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightScale)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightScale];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Float>(Key.SelectedKeyName, RightGesturePart->Scale);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightPrimaryDirection)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightPrimaryDirection];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, RightGesturePart->PrimaryDirection);
-		}
-		if (this->LatestGestureBlackboardKeys.Contains(UBTComposite_MiVRy_LatestGestureData::RightSecondaryDirection)) {
-			const FBlackboardKeySelector& Key = this->LatestGestureBlackboardKeys[UBTComposite_MiVRy_LatestGestureData::RightSecondaryDirection];
-			BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Key.SelectedKeyName, RightGesturePart->SecondaryDirection);
-		}
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightPosition], RightGesturePart->Position);
+		SetBlackboardValue<UBlackboardKeyType_Rotator>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightRotation], RightGesturePart->Rotation);
+		SetBlackboardValue<UBlackboardKeyType_Float>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightScale], RightGesturePart->Scale);
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightPrimaryDirection], RightGesturePart->PrimaryDirection);
+		SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardComponent, Keys[(int32)UBTComposite_MiVRy_LatestGestureData::RightSecondaryDirection], RightGesturePart->SecondaryDirection);
 	}
 }
 
@@ -302,56 +219,24 @@ FString UBTComposite_MiVRy::GetStaticDescription() const
 		return TEXT("MiVRyActor not set");
 	}
 	UBTComposite_MiVRy* me = (UBTComposite_MiVRy*)this;
+	const UMiVRyGestureDatabase* database = this->MiVRyActor->GestureDatabase;
 	FString path = this->MiVRyActor->GestureDatabaseFile.FilePath;
-	if (path != me->GestureDatabaseFile) {
+	if (database != nullptr) {
+		// Gesture names are stored in the asset registry tags, no need to parse the database.
+		me->GestureDatabaseFile = database->GetPathName();
+		UMiVRyGestureDatabase::getGestureNames(database, me->GestureNames);
+	} else {
 		me->GestureDatabaseFile = path;
 		if (path.Len() == 0) {
 			return TEXT("MiVRyActor's GestureDatabaseFile not set");
 		}
-		TArray64<uint8> file_contents;
-		if (FFileHelper::LoadFileToArray(file_contents, *path) == false) {
-			// if (FPaths::IsRelative(path)) {
-			FString relpath = FPaths::Combine(FPaths::ProjectDir(), path);
-			if (FFileHelper::LoadFileToArray(file_contents, *relpath) == false) {
-				FString abspath = FPaths::ConvertRelativePathToFull(relpath);
-				if (FFileHelper::LoadFileToArray(file_contents, *abspath) == false) {
-					return TEXT("MiVRyActor's GestureDatabaseFile not found");
-				}
-			}
-		}
-		me->GestureNames.Empty();
-		bool GestureNamesLoaded = false;
-
-		// Try one-part/one-hand gesture recognition object
-		IGestureRecognition* gro = (IGestureRecognition*)GestureRecognition_create();
-		if (gro != nullptr) {
-			if (gro->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr) == 0) {
-				const int NumGestures = gro->numberOfGestures();
-				me->GestureNames.SetNum(NumGestures);
-				for (int32 i = 0; i < NumGestures; i++) {
-					me->GestureNames[i] = gro->getGestureName(i);
-				}
-				GestureNamesLoaded = true;
-			}
-			delete gro;
-		}
-
-		// Try multi-part gesture combinations object
-		if (GestureNamesLoaded == false) {
-			IGestureCombinations* gco = (IGestureCombinations*)GestureCombinations_create(0);
-			if (gco != nullptr) {
-				if (gco->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr) == 0) {
-					const int NumGestures = gco->numberOfGestureCombinations();
-					me->GestureNames.SetNum(NumGestures);
-					for (int32 i = 0; i < NumGestures; i++) {
-						me->GestureNames[i] = gco->getGestureCombinationName(i);
-					}
-					GestureNamesLoaded = true;
-				}
-				delete gco;
-			}
-		}
-		if (GestureNamesLoaded == false) {
+		// Gesture names are read in the background and cached.
+		const int ret = FMiVRyGestureNameCache::get(path, me->GestureNames);
+		if (ret == -15) {
+			return TEXT("Loading Gesture Database File...");
+		} else if (ret == -3) {
+			return TEXT("MiVRyActor's GestureDatabaseFile not found");
+		} else if (ret != 0) {
 			return TEXT("Failed to load Gesture Database File");
 		}
 	}
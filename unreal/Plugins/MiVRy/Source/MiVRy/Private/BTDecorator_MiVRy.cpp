@@ -21,6 +21,9 @@
 #include "Misc/FileHelper.h"
 #include "GestureRecognition.h"
 #include "GestureCombinations.h"
+#include "MiVRyGestureDatabase.h"
+#include "MiVRyGestureNameCache.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 #include "Runtime/Launch/Resources/Version.h" // for ENGINE_MAJOR_VERSION / ENGINE_MINOR_VERSION
 
 UBTDecorator_MiVRy::UBTDecorator_MiVRy(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -29,8 +32,8 @@ UBTDecorator_MiVRy::UBTDecorator_MiVRy(const FObjectInitializer& ObjectInitializ
 #if ENGINE_MAJOR_VERSION >= 5
 	INIT_DECORATOR_NODE_NOTIFY_FLAGS();
 #endif
-	this->bNotifyTick = true;
-	this->bTickIntervals = 1;
+	this->bNotifyBecomeRelevant = true;
+	this->bNotifyCeaseRelevant = true;
 
 	this->bAllowAbortLowerPri = 0;
 	this->bAllowAbortChildNodes = 1;
@@ -40,78 +43,42 @@ UBTDecorator_MiVRy::UBTDecorator_MiVRy(const FObjectInitializer& ObjectInitializ
 	this->bShowInverseConditionDesc = 0;
 	this->bNotifyActivation = true;
 	this->bNotifyProcessed = true;
-	this->Delegate.BindUFunction(this, "OnGestureIdentified");
-	if (this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
 }
 
-UBTDecorator_MiVRy::~UBTDecorator_MiVRy()
+void UBTDecorator_MiVRy::InitializeFromAsset(UBehaviorTree& Asset)
 {
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
-		}
-		this->BoundMiVRyActor = nullptr;
-	}
-	this->Delegate.Clear();
+	Super::InitializeFromAsset(Asset);
+	this->CompileGestureIds();
 }
 
-void UBTDecorator_MiVRy::PostLoad()
+#if WITH_EDITOR
+void UBTDecorator_MiVRy::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
-	Super::PostLoad();
-	if (!this->BoundMiVRyActor.IsValid() && this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	this->CompileGestureIds();
 }
+#endif
 
-void UBTDecorator_MiVRy::BeginDestroy()
+void UBTDecorator_MiVRy::CompileGestureIds()
 {
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
+	int32 NumBits = 0;
+	for (const int32 GestureId : this->GestureIDs) {
+		NumBits = FMath::Max(NumBits, GestureId + 2);
+	}
+	this->GestureIdBits.Init(false, NumBits);
+	for (const int32 GestureId : this->GestureIDs) {
+		if (GestureId >= -1) {
+			this->GestureIdBits[GestureId + 1] = true;
 		}
-		this->BoundMiVRyActor = nullptr;
 	}
-	this->Delegate.Clear();
-	Super::BeginDestroy();
 }
 
-void UBTDecorator_MiVRy::OnNodeActivation(FBehaviorTreeSearchData& SearchData)
+bool UBTDecorator_MiVRy::IsGestureIdListed(int32 GestureId) const
 {
-	if (!this->BoundMiVRyActor.IsValid() && this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
+	const int32 Index = GestureId + 1;
+	return Index >= 0 && Index < this->GestureIdBits.Num() && this->GestureIdBits[Index];
 }
 
-#if WITH_EDITOR
-void UBTDecorator_MiVRy::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
-{
-	if (PropertyChangedEvent.Property == nullptr) {
-		return;
-	}
-	FName PropertyName = PropertyChangedEvent.Property->GetFName();
-	if (PropertyName != GET_MEMBER_NAME_CHECKED(UBTDecorator_MiVRy, MiVRyActor)) {
-		Super::PostEditChangeProperty(PropertyChangedEvent);
-		return;
-	} // else:
-	if (this->BoundMiVRyActor.IsValid()) {
-		if (this->BoundMiVRyActor.IsValid()) {
-			this->BoundMiVRyActor->OnGestureIdentifiedDelegate.RemoveAll(this);
-		}
-		this->BoundMiVRyActor = nullptr;
-	}
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-	if (this->MiVRyActor.IsValid()) {
-		this->MiVRyActor->OnGestureIdentifiedDelegate.Add(this->Delegate);
-		this->BoundMiVRyActor = this->MiVRyActor;
-	}
-}
-#endif
-
 uint16 UBTDecorator_MiVRy::GetInstanceMemorySize() const
 {
 	return sizeof(UBTDecorator_MiVRyMemory);
@@ -128,6 +95,8 @@ void UBTDecorator_MiVRy::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uin
 	if (InitType == EBTMemoryInit::Initialize)
 	{
 		Memory->LatestGestureCounter = 0;
+		Memory->LatestGestureId = -1;
+		Memory->GestureEventHandle.Reset();
 	}
 }
 
@@ -143,63 +112,89 @@ void UBTDecorator_MiVRy::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8*
 bool UBTDecorator_MiVRy::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
 {
 	UBTDecorator_MiVRyMemory* Memory = CastInstanceNodeMemory<UBTDecorator_MiVRyMemory>(NodeMemory);
-	if (this->LatestGestureCounter == Memory->LatestGestureCounter) { // already processed latest gesture
-		if (this->LatestGestureId >= 0 && this->EvalEveryGestureOnlyOnce) {
+	const AMiVRyActor* Actor = this->MiVRyActor.Get();
+	const uint32 LatestGestureCounter = Actor ? Actor->getGestureEventCounter() : Memory->LatestGestureCounter;
+	if (LatestGestureCounter == Memory->LatestGestureCounter) { // already processed latest gesture
+		if (Memory->LatestGestureId >= 0 && this->EvalEveryGestureOnlyOnce) {
 			return false;
 		} // else: no-gesture or latest gesture is allowed mutliple times
 	} else {
-		Memory->LatestGestureCounter = this->LatestGestureCounter;
+		Memory->LatestGestureCounter = LatestGestureCounter;
+		const AMiVRyActor::GestureEvent* Event = Actor->getGestureEvent(LatestGestureCounter);
+		if (Event != nullptr && Event->gesture_id >= 0 && Event->similarity >= this->SimilarityThreshold) {
+			Memory->LatestGestureId = Event->gesture_id;
+		} else {
+			Memory->LatestGestureId = -1;
+		}
 	}
 
 	switch (this->GestureIdListUse) {
 		case GestureRecognition_GestureIdListUse::Whitelist:
-			return this->GestureIDs.Contains((int32)this->LatestGestureId);
+			return this->IsGestureIdListed(Memory->LatestGestureId);
 		case GestureRecognition_GestureIdListUse::Blacklist:
-			return !this->GestureIDs.Contains((int32)this->LatestGestureId);
+			return !this->IsGestureIdListed(Memory->LatestGestureId);
 		case GestureRecognition_GestureIdListUse::Ignore:
 		default:
 			return true;
 	}
 }
 
-void UBTDecorator_MiVRy::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+void UBTDecorator_MiVRy::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
-#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
-	UBTDecorator_MiVRyMemory* Memory = CastInstanceNodeMemory<UBTDecorator_MiVRyMemory>(NodeMemory);
-	if (this->LatestGestureCounter == Memory->LatestGestureCounter) { // already processed latest gesture
+	if (this->FlowAbortMode == EBTFlowAbortMode::None) {
 		return;
-	} // else:
-	if (FlowAbortMode == EBTFlowAbortMode::None) {
+	}
+	AMiVRyActor* Actor = this->MiVRyActor.Get();
+	if (Actor == nullptr) {
 		return;
-	} // else: FlowAbortMode == EBTFlowAbortMode::Self
-	const bool IsOnActiveBranch = OwnerComp.IsExecutingBranch(this->GetMyNode(), this->GetChildIndex());
-	if (!IsOnActiveBranch) {
+	}
+	UBTDecorator_MiVRyMemory* Memory = CastInstanceNodeMemory<UBTDecorator_MiVRyMemory>(NodeMemory);
+	Memory->GestureEventHandle = Actor->OnGestureIdentifiedNative.AddUObject(this, &UBTDecorator_MiVRy::OnGestureIdentified, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp));
+}
+
+void UBTDecorator_MiVRy::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UBTDecorator_MiVRyMemory* Memory = CastInstanceNodeMemory<UBTDecorator_MiVRyMemory>(NodeMemory);
+	if (!Memory->GestureEventHandle.IsValid()) {
 		return;
 	}
-	const bool Pass = this->CalculateRawConditionValue(OwnerComp, NodeMemory);
-	if (Pass) {
-		OwnerComp.RequestBranchActivation(*this, true);
-	} else {
-		OwnerComp.RequestBranchDeactivation(*this);
+	AMiVRyActor* Actor = this->MiVRyActor.Get();
+	if (Actor != nullptr) {
+		Actor->OnGestureIdentifiedNative.Remove(Memory->GestureEventHandle);
 	}
-#endif
+	Memory->GestureEventHandle.Reset();
 }
 
 void UBTDecorator_MiVRy::OnGestureIdentified(
 	AMiVRyActor* Source,
 	GestureRecognition_Identification Result,
 	int GestureID,
-	FString GestureName,
+	const FString& GestureName,
 	float Similarity,
-	const TArray<FMiVRyGesturePart>& GestureParts
+	const TArray<FMiVRyGesturePart>& GestureParts,
+	TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp
 )
 {
-	if (GestureID >= 0 && Similarity >= this->SimilarityThreshold) {
-		this->LatestGestureId = GestureID;
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
+	UBehaviorTreeComponent* BehaviorTreeComponent = OwnerComp.Get();
+	if (BehaviorTreeComponent == nullptr) {
+		return;
+	}
+	const bool IsOnActiveBranch = BehaviorTreeComponent->IsExecutingBranch(this->GetMyNode(), this->GetChildIndex());
+	if (!IsOnActiveBranch) {
+		return;
+	}
+	uint8* NodeMemory = BehaviorTreeComponent->GetNodeMemory(this, BehaviorTreeComponent->FindInstanceContainingNode(this));
+	if (NodeMemory == nullptr) {
+		return;
+	}
+	const bool Pass = this->CalculateRawConditionValue(*BehaviorTreeComponent, NodeMemory);
+	if (Pass) {
+		BehaviorTreeComponent->RequestBranchActivation(*this, true);
 	} else {
-		this->LatestGestureId = -1;
+		BehaviorTreeComponent->RequestBranchDeactivation(*this);
 	}
-	this->LatestGestureCounter += 1;
+#endif
 }
 
 FString UBTDecorator_MiVRy::GetStaticDescription() const
@@ -211,56 +206,24 @@ FString UBTDecorator_MiVRy::GetStaticDescription() const
 		return TEXT("MiVRyActor not set");
 	}
 	UBTDecorator_MiVRy* me = (UBTDecorator_MiVRy*)this;
+	const UMiVRyGestureDatabase* database = this->MiVRyActor->GestureDatabase;
 	FString path = this->MiVRyActor->GestureDatabaseFile.FilePath;
-	if (path != me->GestureDatabaseFile) {
+	if (database != nullptr) {
+		// Gesture names are stored in the asset registry tags, no need to parse the database.
+		me->GestureDatabaseFile = database->GetPathName();
+		UMiVRyGestureDatabase::getGestureNames(database, me->GestureNames);
+	} else {
 		me->GestureDatabaseFile = path;
 		if (path.Len() == 0) {
 			return TEXT("MiVRyActor's GestureDatabaseFile not set");
 		}
-		TArray64<uint8> file_contents;
-		if (FFileHelper::LoadFileToArray(file_contents, *path) == false) {
-			// if (FPaths::IsRelative(path)) {
-			FString relpath = FPaths::Combine(FPaths::ProjectDir(), path);
-			if (FFileHelper::LoadFileToArray(file_contents, *relpath) == false) {
-				FString abspath = FPaths::ConvertRelativePathToFull(relpath);
-				if (FFileHelper::LoadFileToArray(file_contents, *abspath) == false) {
-					return TEXT("MiVRyActor's GestureDatabaseFile not found");
-				}
-			}
-		}
-		me->GestureNames.Empty();
-		bool GestureNamesLoaded = false;
-
-		// Try one-part/one-hand gesture recognition object
-		IGestureRecognition* gro = (IGestureRecognition*)GestureRecognition_create();
-		if (gro != nullptr) {
-			if (gro->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr) == 0) {
-				const int NumGestures = gro->numberOfGestures();
-				me->GestureNames.SetNum(NumGestures);
-				for (int32 i = 0; i < NumGestures; i++) {
-					me->GestureNames[i] = gro->getGestureName(i);
-				}
-				GestureNamesLoaded = true;
-			}
-			delete gro;
-		}
-
-		// Try multi-part gesture combinations object
-		if (GestureNamesLoaded == false) {
-			IGestureCombinations* gco = (IGestureCombinations*)GestureCombinations_create(0);
-			if (gco != nullptr) {
-				if (gco->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr) == 0) {
-					const int NumGestures = gco->numberOfGestureCombinations();
-					me->GestureNames.SetNum(NumGestures);
-					for (int32 i = 0; i < NumGestures; i++) {
-						me->GestureNames[i] = gco->getGestureCombinationName(i);
-					}
-					GestureNamesLoaded = true;
-				}
-				delete gco;
-			}
-		}
-		if (GestureNamesLoaded == false) {
+		// Gesture names are read in the background and cached.
+		const int ret = FMiVRyGestureNameCache::get(path, me->GestureNames);
+		if (ret == -15) {
+			return TEXT("Loading Gesture Database File...");
+		} else if (ret == -3) {
+			return TEXT("MiVRyActor's GestureDatabaseFile not found");
+		} else if (ret != 0) {
 			return TEXT("Failed to load Gesture Database File");
 		}
 	}
@@ -20,6 +20,7 @@
 #include "GestureCombinationsActor.h"
 #include "GestureCombinations.h"
 #include "Misc/MessageDialog.h"
+#include "Async/Async.h"
 #include "Misc/Paths.h"
 
 AGestureCombinationsActor::AGestureCombinationsActor()
@@ -30,8 +31,14 @@ AGestureCombinationsActor::AGestureCombinationsActor()
 	TrainingUpdateMetadata.delegate = &this->OnTrainingUpdateDelegate;
 	TrainingFinishMetadata.actor = this;
 	TrainingFinishMetadata.delegate = &this->OnTrainingFinishDelegate;
+	LoadingUpdateMetadata.actor = this;
+	LoadingUpdateMetadata.delegate = &this->OnLoadingUpdateDelegate;
 	LoadingFinishMetadata.actor = this;
 	LoadingFinishMetadata.delegate = &this->OnLoadingFinishDelegate;
+	SavingUpdateMetadata.actor = this;
+	SavingUpdateMetadata.delegate = &this->OnSavingUpdateDelegate;
+	SavingFinishMetadata.actor = this;
+	SavingFinishMetadata.delegate = &this->OnSavingFinishDelegate;
 }
 
 
@@ -81,6 +88,13 @@ void AGestureCombinationsActor::BeginPlay()
 void AGestureCombinationsActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	if (this->SavePending && this->gco && !this->gco->isSaving()) {
+		this->SavePending = false;
+		const int ret = this->saveToFileAsync(this->PendingSavePath);
+		if (ret != 0) {
+			UE_LOG(LogTemp, Warning, TEXT("[GestureCombinationsActor] Failed to start autosave: %s"), *UMiVRyUtil::errorCodeToString(ret));
+		}
+	}
 }
 
 
@@ -482,6 +496,68 @@ int AGestureCombinationsActor::copyGesture(int from_part, int from_gesture_index
 	return this->gco->copyGesture(from_part, from_gesture_index, to_part, to_gesture_index, mirror_axis);
 }
 
+int AGestureCombinationsActor::mirrorPart(int from_part, int to_part)
+{
+	if (!this->gco)
+		return -99;
+	const int num_parts = this->gco->numberOfParts();
+	if (from_part < 0 || from_part >= num_parts || to_part < 0 || to_part >= num_parts || from_part == to_part)
+		return -18;
+	const int num_gestures = this->gco->numberOfGestures(from_part);
+	if (num_gestures < 0)
+		return num_gestures;
+	const int num_old_gestures = this->gco->numberOfGestures(to_part);
+	if (num_old_gestures < 0)
+		return num_old_gestures;
+	// Remember which gestures the combinations use for the target part.
+	const int num_combinations = this->gco->numberOfGestureCombinations();
+	TArray<int> combination_part_gestures;
+	combination_part_gestures.SetNum(num_combinations > 0 ? num_combinations : 0);
+	for (int i = 0; i < combination_part_gestures.Num(); i++) {
+		combination_part_gestures[i] = this->gco->getCombinationPartGesture(i, to_part);
+	}
+	// Append the mirrored gestures first, so that the target part is left unchanged if copying fails.
+	int ret = 0;
+	int num_copied = 0;
+	for (; num_copied < num_gestures; num_copied++) {
+		ret = this->copyGesture(from_part, num_copied, to_part, -1, true);
+		if (ret < 0)
+			break;
+	}
+	if (ret < 0) {
+		UE_LOG(LogTemp, Error, TEXT("[GestureCombinationsActor.mirrorPart] Failed to copy gesture %i of part %i: %s"), num_copied, from_part, *UMiVRyUtil::errorCodeToString(ret));
+		for (int i = num_old_gestures + num_copied - 1; i >= num_old_gestures; i--) {
+			this->gco->deleteGesture(to_part, i);
+		}
+		return ret; // the target part and the combinations are unchanged
+	}
+	// Remove the old gestures, so that the mirrored copies get the IDs of the source gestures.
+	for (int num_deleted = 0; num_deleted < num_old_gestures; num_deleted++) {
+		ret = this->gco->deleteGesture(to_part, 0);
+		if (ret != 0) {
+			UE_LOG(LogTemp, Error, TEXT("[GestureCombinationsActor.mirrorPart] Failed to delete gesture %i of part %i: %s"), num_deleted, to_part, *UMiVRyUtil::errorCodeToString(ret));
+			// The remaining old gestures have moved, so the combinations can not be restored.
+			const int num_remaining = num_old_gestures - num_deleted;
+			for (int i = num_remaining + num_gestures - 1; i >= num_remaining; i--) {
+				this->gco->deleteGesture(to_part, i);
+			}
+			return ret;
+		}
+	}
+	for (int i = 0; i < combination_part_gestures.Num(); i++) {
+		const int part_gesture = combination_part_gestures[i];
+		if (part_gesture < 0) {
+			continue;
+		}
+		if (part_gesture >= num_gestures) {
+			UE_LOG(LogTemp, Warning, TEXT("[GestureCombinationsActor.mirrorPart] Gesture combination %i used gesture %i of part %i, which has no mirrored counterpart."), i, part_gesture, to_part);
+			continue;
+		}
+		this->gco->setCombinationPartGesture(i, to_part, part_gesture);
+	}
+	return 0;
+}
+
 
 float AGestureCombinationsActor::gestureRecognitionScore(int part, bool all_samples)
 {
@@ -603,14 +679,8 @@ int AGestureCombinationsActor::getGestureSampleStroke(int part, int gesture_inde
 	Rotations.SetNum(len);
 	HMD_Locations.SetNum(len);
 	HMD_Rotations.SetNum(len);
-	FQuat quat;
-	for (int i = 0; i < len; i++) {
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &p[3*i], &q[4*i], GestureRecognition_DeviceType::Controller, Locations[i], quat);
-		Rotations[i] = quat.Rotator();
-
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &hmd_p[3*i], &hmd_q[4*i], GestureRecognition_DeviceType::Headset, HMD_Locations[i], quat);
-		HMD_Rotations[i] = quat.Rotator();
-	}
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Controller).convertOutputArray(p, q, Locations, Rotations);
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Headset).convertOutputArray(hmd_p, hmd_q, HMD_Locations, HMD_Rotations);
 	delete[] p;
 	delete[] q;
 	delete[] hmd_p;
@@ -665,11 +735,7 @@ int AGestureCombinationsActor::getGestureMeanStroke(int part, int gesture_index,
 	const int len = (ret < mean_len) ? ret : mean_len;
 	Locations.SetNum(len);
 	Rotations.SetNum(len);
-	FQuat quat;
-	for (int i = 0; i < len; i++) {
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &p[3 * i], &q[4 * i], GestureRecognition_DeviceType::Controller, Locations[i], quat);
-		Rotations[i] = quat.Rotator();
-	}
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Controller).convertOutputArray(p, q, Locations, Rotations);
 	delete[] p;
 	delete[] q;
 	return len;
@@ -748,11 +814,11 @@ int AGestureCombinationsActor::loadFromFile(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gco->loadFromFile(TCHAR_TO_ANSI(*path_str));
 	}
 	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
+	UMiVRyUtil::readFileToBuffer((result == GestureRecognition_Result::Then) ? path_str : path.FilePath, result, buffer);
 	if (result == GestureRecognition_Result::Then) {
 		return this->gco->loadFromBuffer((const char*)buffer.GetData(), buffer.Num(), nullptr);
 	}
@@ -773,11 +839,11 @@ int AGestureCombinationsActor::importFromFile(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gco->importFromFile(TCHAR_TO_ANSI(*path_str));
 	}
 	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
+	UMiVRyUtil::readFileToBuffer((result == GestureRecognition_Result::Then) ? path_str : path.FilePath, result, buffer);
 	if (result == GestureRecognition_Result::Then) {
 		return this->gco->importFromBuffer((const char*)buffer.GetData(), buffer.Num(), nullptr);
 	}
@@ -1020,6 +1086,19 @@ int AGestureCombinationsActor::saveToFileAsync(const FFilePath& path)
 	return this->gco->saveToFileAsync(TCHAR_TO_ANSI(*path_str));
 }
 
+int AGestureCombinationsActor::requestAutosave(const FFilePath& path)
+{
+	if (!this->gco)
+		return -99;
+	if (this->gco->isSaving()) {
+		this->PendingSavePath = path;
+		this->SavePending = true;
+		return 0;
+	}
+	this->SavePending = false;
+	return this->saveToFileAsync(path);
+}
+
 bool AGestureCombinationsActor::isSaving()
 {
 	if (!this->gco)
@@ -1054,15 +1133,40 @@ int AGestureCombinationsActor::loadFromFileAsync(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gco->loadFromFileAsync(TCHAR_TO_ANSI(*path_str), nullptr);
 	}
-	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
-	if (result == GestureRecognition_Result::Then) {
-		return this->gco->loadFromBufferAsync((const char*)buffer.GetData(), buffer.Num(), nullptr);
-	}
-	return -3;
+	if (this->AsyncFileReading || this->gco->isLoading()) {
+		return -15; // currently loading
+	}
+	// Read (and decompress) the file on a worker thread, then hand the buffer to the asynchronous loader on the game thread.
+	this->AsyncFileReading = true;
+	const int32 request = ++this->AsyncFileReadingRequest;
+	const FString read_path = (result == GestureRecognition_Result::Then) ? path_str : path.FilePath;
+	TWeakObjectPtr<AGestureCombinationsActor> weak_this(this);
+	Async(EAsyncExecution::ThreadPool, [weak_this, request, read_path]() {
+		TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> buffer = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		GestureRecognition_Result read_result;
+		UMiVRyUtil::readFileToBuffer(read_path, read_result, *buffer);
+		AsyncTask(ENamedThreads::GameThread, [weak_this, request, buffer, read_result]() {
+			AGestureCombinationsActor* self = weak_this.Get();
+			if (!self || !self->AsyncFileReading || self->AsyncFileReadingRequest != request) {
+				return; // actor destroyed or loading cancelled
+			}
+			self->AsyncFileReading = false;
+			int ret = -3;
+			if (!self->gco) {
+				ret = -99;
+			} else if (read_result == GestureRecognition_Result::Then) {
+				self->AsyncLoadingBuffer = MoveTemp(*buffer);
+				ret = self->gco->loadFromBufferAsync((const char*)self->AsyncLoadingBuffer.GetData(), self->AsyncLoadingBuffer.Num(), nullptr);
+			}
+			if (ret != 0) {
+				self->OnLoadingFinishDelegate.Broadcast(self, ret);
+			}
+		});
+	});
+	return 0;
 }
 
 int AGestureCombinationsActor::loadFromBufferAsync(const TArray<uint8>& buffer)
@@ -1087,6 +1191,8 @@ int AGestureCombinationsActor::loadFromBufferAsync(const TArray<uint8>& buffer)
 
 bool AGestureCombinationsActor::isLoading()
 {
+	if (this->AsyncFileReading)
+		return true;
 	if (!this->gco)
 		return false;
 	return this->gco->isLoading();
@@ -1094,6 +1200,11 @@ bool AGestureCombinationsActor::isLoading()
 
 int AGestureCombinationsActor::cancelLoading()
 {
+	if (this->AsyncFileReading) {
+		this->AsyncFileReading = false;
+		this->AsyncFileReadingRequest++;
+		return 0;
+	}
 	if (!this->gco)
 		return -99;
 	return this->gco->cancelLoading();
@@ -1307,7 +1418,22 @@ void AGestureCombinationsActor::setRotationalFrameOfReferenceRotationOrder(Gestu
 void AGestureCombinationsActor::TrainingCallbackFunction(double performance, TrainingCallbackMetadata* metadata) {
 	if (!metadata || !metadata->delegate || !metadata->actor)
 		return;
-	metadata->delegate->Broadcast(metadata->actor, performance);
+	// Training progress is reported from the training threads: forward it to the game thread in order.
+	TWeakObjectPtr<AGestureCombinationsActor> weak_actor(metadata->actor);
+	FTrainingCallbackDelegate* delegate = metadata->delegate;
+	AsyncTask(ENamedThreads::GameThread, [weak_actor, delegate, performance]() {
+		AGestureCombinationsActor* actor = weak_actor.Get();
+		if (actor == nullptr) {
+			return;
+		}
+		delegate->Broadcast(actor, (float)performance);
+		if (delegate == &actor->OnTrainingFinishDelegate && actor->OnPartTrainingFinishDelegate.IsBound() && actor->gco) {
+			const int num_parts = actor->gco->numberOfParts();
+			for (int part = 0; part < num_parts; part++) {
+				actor->OnPartTrainingFinishDelegate.Broadcast(actor, part, (float)actor->gco->gestureRecognitionScore(part));
+			}
+		}
+	});
 }
 
 void AGestureCombinationsActor::LoadingCallbackFunction(int result, LoadingCallbackMetadata* metadata)
@@ -1315,7 +1441,18 @@ void AGestureCombinationsActor::LoadingCallbackFunction(int result, LoadingCallb
 	if (!metadata || !metadata->delegate || !metadata->actor) {
 		return;
 	}
-	metadata->delegate->Broadcast(metadata->actor, result);
+	if (IsInGameThread()) {
+		metadata->delegate->Broadcast(metadata->actor, result);
+		return;
+	}
+	// Loading progress is reported from the loading thread: forward it to the game thread in order.
+	TWeakObjectPtr<AGestureCombinationsActor> weak_actor(metadata->actor);
+	FLoadingCallbackDelegate* delegate = metadata->delegate;
+	AsyncTask(ENamedThreads::GameThread, [weak_actor, delegate, result]() {
+		if (weak_actor.IsValid()) {
+			delegate->Broadcast(weak_actor.Get(), result);
+		}
+	});
 }
 
 void AGestureCombinationsActor::SavingCallbackFunction(int result, SavingCallbackMetadata* metadata)
@@ -1323,5 +1460,16 @@ void AGestureCombinationsActor::SavingCallbackFunction(int result, SavingCallbac
 	if (!metadata || !metadata->delegate || !metadata->actor) {
 		return;
 	}
-	metadata->delegate->Broadcast(metadata->actor, result);
+	if (IsInGameThread()) {
+		metadata->delegate->Broadcast(metadata->actor, result);
+		return;
+	}
+	// Saving progress is reported from the saving thread: forward it to the game thread in order.
+	TWeakObjectPtr<AGestureCombinationsActor> weak_actor(metadata->actor);
+	FSavingCallbackDelegate* delegate = metadata->delegate;
+	AsyncTask(ENamedThreads::GameThread, [weak_actor, delegate, result]() {
+		if (weak_actor.IsValid()) {
+			delegate->Broadcast(weak_actor.Get(), result);
+		}
+	});
 }
@@ -30,8 +30,14 @@ AGestureRecognitionActor::AGestureRecognitionActor()
 	TrainingUpdateMetadata.delegate = &this->OnTrainingUpdateDelegate;
 	TrainingFinishMetadata.actor = this;
 	TrainingFinishMetadata.delegate = &this->OnTrainingFinishDelegate;
+	LoadingUpdateMetadata.actor = this;
+	LoadingUpdateMetadata.delegate = &this->OnLoadingUpdateDelegate;
 	LoadingFinishMetadata.actor = this;
 	LoadingFinishMetadata.delegate = &this->OnLoadingFinishDelegate;
+	SavingUpdateMetadata.actor = this;
+	SavingUpdateMetadata.delegate = &this->OnSavingUpdateDelegate;
+	SavingFinishMetadata.actor = this;
+	SavingFinishMetadata.delegate = &this->OnSavingFinishDelegate;
 }
 
 AGestureRecognitionActor::~AGestureRecognitionActor()
@@ -76,6 +82,13 @@ void AGestureRecognitionActor::BeginPlay()
 void AGestureRecognitionActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	if (this->SavePending && this->gro && !this->gro->isSaving()) {
+		this->SavePending = false;
+		const int ret = this->saveToFileAsync(this->PendingSavePath);
+		if (ret != 0) {
+			UE_LOG(LogTemp, Warning, TEXT("[GestureRecognitionActor] Failed to start autosave: %s"), *UMiVRyUtil::errorCodeToString(ret));
+		}
+	}
 }
 
 int AGestureRecognitionActor::activateLicense(const FString& license_name, const FString& license_key)
@@ -696,6 +709,8 @@ int AGestureRecognitionActor::getGestureSampleStroke(int gesture_index, int samp
 	if (ret <= 0) {
 		delete[] p;
 		delete[] q;
+		delete[] hmd_p;
+		delete[] hmd_q;
 		Locations.Empty(0);
 		Rotations.Empty(0);
 		HMD_Locations.Empty(0);
@@ -708,12 +723,8 @@ int AGestureRecognitionActor::getGestureSampleStroke(int gesture_index, int samp
 	Rotations.SetNum(len);
 	HMD_Locations.SetNum(len);
 	HMD_Rotations.SetNum(len);
-	for (int i = 0; i < len; i++) {
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &p[i*3], &q[i*4], GestureRecognition_DeviceType::Controller, Locations[i], quat);
-		Rotations[i] = quat.Rotator();
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &hmd_p[i*3], &hmd_q[i*4], GestureRecognition_DeviceType::Headset, HMD_Locations[i], quat);
-		HMD_Rotations[i] = quat.Rotator();
-	}
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Controller).convertOutputArray(p, q, Locations, Rotations);
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Headset).convertOutputArray(hmd_p, hmd_q, HMD_Locations, HMD_Rotations);
 	delete[] p;
 	delete[] q;
 	delete[] hmd_p;
@@ -770,11 +781,7 @@ int AGestureRecognitionActor::getGestureMeanStroke(int gesture_index, TArray<FVe
 	const int len = (ret < mean_len) ? ret : mean_len;
 	Locations.SetNum(len);
 	Rotations.SetNum(len);
-	FQuat quat;
-	for (int i = 0; i < len; i++) {
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, &p[3 * i], &q[4 * i], GestureRecognition_DeviceType::Controller, Locations[i], quat);
-		Rotations[i] = quat.Rotator();
-	}
+	FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Controller).convertOutputArray(p, q, Locations, Rotations);
 	delete[] p;
 	delete[] q;
 	return len;
@@ -887,11 +894,11 @@ int AGestureRecognitionActor::loadFromFile(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gro->loadFromFile(TCHAR_TO_ANSI(*path_str), nullptr);
 	}
 	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
+	UMiVRyUtil::readFileToBuffer((result == GestureRecognition_Result::Then) ? path_str : path.FilePath, result, buffer);
 	if (result == GestureRecognition_Result::Then) {
 		return this->gro->loadFromBuffer((const char*)buffer.GetData(), buffer.Num(), nullptr);
 	}
@@ -914,11 +921,11 @@ int AGestureRecognitionActor::importFromFile(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gro->importFromFile(TCHAR_TO_ANSI(*path_str), nullptr);
 	}
 	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
+	UMiVRyUtil::readFileToBuffer((result == GestureRecognition_Result::Then) ? path_str : path.FilePath, result, buffer);
 	if (result == GestureRecognition_Result::Then) {
 		return this->gro->importFromBuffer((const char*)buffer.GetData(), buffer.Num(), nullptr);
 	}
@@ -957,6 +964,19 @@ int AGestureRecognitionActor::saveToFileAsync(const FFilePath& path)
 	return this->gro->saveToFileAsync(TCHAR_TO_ANSI(*path_str));
 }
 
+int AGestureRecognitionActor::requestAutosave(const FFilePath& path)
+{
+	if (!this->gro)
+		return -99;
+	if (this->gro->isSaving()) {
+		this->PendingSavePath = path;
+		this->SavePending = true;
+		return 0;
+	}
+	this->SavePending = false;
+	return this->saveToFileAsync(path);
+}
+
 bool AGestureRecognitionActor::isSaving()
 {
 	if (!this->gro)
@@ -991,15 +1011,40 @@ int AGestureRecognitionActor::loadFromFileAsync(const FFilePath& path)
 	FString path_str;
 	GestureRecognition_Result result;
 	UMiVRyUtil::findFile(path.FilePath, result, path_str);
-	if (result == GestureRecognition_Result::Then) {
+	if (result == GestureRecognition_Result::Then && !UMiVRyUtil::isCompressedDatabaseFile(path_str)) {
 		return this->gro->loadFromFileAsync(TCHAR_TO_ANSI(*path_str), nullptr);
 	}
-	TArray<uint8> buffer;
-	UMiVRyUtil::readFileToBuffer(path.FilePath, result, buffer);
-	if (result == GestureRecognition_Result::Then) {
-		return this->gro->loadFromBufferAsync((const char*)buffer.GetData(), buffer.Num(), nullptr);
-	}
-	return -3;
+	if (this->AsyncFileReading || this->gro->isLoading()) {
+		return -15; // currently loading
+	}
+	// Read (and decompress) the file on a worker thread, then hand the buffer to the asynchronous loader on the game thread.
+	this->AsyncFileReading = true;
+	const int32 request = ++this->AsyncFileReadingRequest;
+	const FString read_path = (result == GestureRecognition_Result::Then) ? path_str : path.FilePath;
+	TWeakObjectPtr<AGestureRecognitionActor> weak_this(this);
+	Async(EAsyncExecution::ThreadPool, [weak_this, request, read_path]() {
+		TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> buffer = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		GestureRecognition_Result read_result;
+		UMiVRyUtil::readFileToBuffer(read_path, read_result, *buffer);
+		AsyncTask(ENamedThreads::GameThread, [weak_this, request, buffer, read_result]() {
+			AGestureRecognitionActor* self = weak_this.Get();
+			if (!self || !self->AsyncFileReading || self->AsyncFileReadingRequest != request) {
+				return; // actor destroyed or loading cancelled
+			}
+			self->AsyncFileReading = false;
+			int ret = -3;
+			if (!self->gro) {
+				ret = -99;
+			} else if (read_result == GestureRecognition_Result::Then) {
+				self->AsyncLoadingBuffer = MoveTemp(*buffer);
+				ret = self->gro->loadFromBufferAsync((const char*)self->AsyncLoadingBuffer.GetData(), self->AsyncLoadingBuffer.Num(), nullptr);
+			}
+			if (ret != 0) {
+				self->OnLoadingFinishDelegate.Broadcast(self, ret);
+			}
+		});
+	});
+	return 0;
 }
 
 int AGestureRecognitionActor::loadFromBufferAsync(const TArray<uint8>& buffer)
@@ -1024,6 +1069,8 @@ int AGestureRecognitionActor::loadFromBufferAsync(const TArray<uint8>& buffer)
 
 bool AGestureRecognitionActor::isLoading()
 {
+	if (this->AsyncFileReading)
+		return true;
 	if (!this->gro)
 		return false;
 	return this->gro->isLoading();
@@ -1031,6 +1078,11 @@ bool AGestureRecognitionActor::isLoading()
 
 int AGestureRecognitionActor::cancelLoading()
 {
+	if (this->AsyncFileReading) {
+		this->AsyncFileReading = false;
+		this->AsyncFileReadingRequest++;
+		return 0;
+	}
 	if (!this->gro)
 		return -99;
 	return this->gro->cancelLoading();
@@ -1237,7 +1289,18 @@ void AGestureRecognitionActor::LoadingCallbackFunction(int result, LoadingCallba
 	if (!metadata || !metadata->delegate || !metadata->actor) {
 		return;
 	}
-	metadata->delegate->Broadcast(metadata->actor, result);
+	if (IsInGameThread()) {
+		metadata->delegate->Broadcast(metadata->actor, result);
+		return;
+	}
+	// Loading progress is reported from the loading thread: forward it to the game thread in order.
+	TWeakObjectPtr<AGestureRecognitionActor> weak_actor(metadata->actor);
+	FLoadingCallbackDelegate* delegate = metadata->delegate;
+	AsyncTask(ENamedThreads::GameThread, [weak_actor, delegate, result]() {
+		if (weak_actor.IsValid()) {
+			delegate->Broadcast(weak_actor.Get(), result);
+		}
+	});
 }
 
 void AGestureRecognitionActor::SavingCallbackFunction(int result, SavingCallbackMetadata* metadata)
@@ -1245,5 +1308,16 @@ void AGestureRecognitionActor::SavingCallbackFunction(int result, SavingCallback
 	if (!metadata || !metadata->delegate || !metadata->actor) {
 		return;
 	}
-	metadata->delegate->Broadcast(metadata->actor, result);
+	if (IsInGameThread()) {
+		metadata->delegate->Broadcast(metadata->actor, result);
+		return;
+	}
+	// Saving progress is reported from the saving thread: forward it to the game thread in order.
+	TWeakObjectPtr<AGestureRecognitionActor> weak_actor(metadata->actor);
+	FSavingCallbackDelegate* delegate = metadata->delegate;
+	AsyncTask(ENamedThreads::GameThread, [weak_actor, delegate, result]() {
+		if (weak_actor.IsValid()) {
+			delegate->Broadcast(weak_actor.Get(), result);
+		}
+	});
 }
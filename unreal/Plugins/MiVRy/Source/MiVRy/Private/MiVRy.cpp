@@ -23,9 +23,12 @@
 #include "Engine.h"
 #include "Camera/PlayerCameraManager.h"
 #include "GestureRecognition.h"
+#include "MiVRyGestureNameCache.h"
 
 #define LOCTEXT_NAMESPACE "FMiVRyModule"
 
+DEFINE_LOG_CATEGORY(LogMiVRy);
+
 void FMiVRyModule::StartupModule()
 {
 	FString BaseDir = IPluginManager::Get().FindPlugin("MiVRy")->GetBaseDir();
@@ -61,6 +64,7 @@ void FMiVRyModule::StartupModule()
 
 void FMiVRyModule::ShutdownModule()
 {
+	FMiVRyGestureNameCache::clear();
 	if (this->LibraryHandle != nullptr) {
 		FPlatformProcess::FreeDllHandle(this->LibraryHandle);
 		this->LibraryHandle = nullptr;
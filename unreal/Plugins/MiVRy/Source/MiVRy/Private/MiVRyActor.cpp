@@ -17,6 +17,7 @@
  */
 
 #include "MiVRyActor.h"
+#include "MiVRy.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/Paths.h"
@@ -28,6 +29,11 @@
 #include "EnhancedInputComponent.h"
 #include "GestureRecognition.h"
 #include "GestureCombinations.h"
+#include "MiVRyDatabaseCache.h"
+#include "MiVRyWorldSubsystem.h"
+#include "MiVRyGestureDatabase.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
 
 void FMiVRyGesturePart::parse(const double pos[3], double scale, const double dir0[3], const double dir1[3], const double dir2[3], GestureRecognition_CoordinateSystem coordsys)
 {
@@ -100,6 +106,9 @@ AMiVRyActor::AMiVRyActor()
 
 AMiVRyActor::~AMiVRyActor()
 {
+	if (this->ProcessingTask.IsValid()) {
+		this->ProcessingTask.Wait();
+	}
 	if (this->gro) {
 		GestureRecognition_delete(this->gro);
 		this->gro = nullptr;
@@ -116,113 +125,208 @@ void AMiVRyActor::BeginPlay()
 
 	this->SetupPlayerInputComponent(this->InputComponent);
 
-	FString path = this->GestureDatabaseFile.FilePath;
-	TArray64<uint8> file_contents;
-	if (FFileHelper::LoadFileToArray(file_contents, *path)) {
-		UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Found gesture database file at '%s'"), *path);
-	} else {
-		UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Could not find gesture database file at '%s'"), *path);
-		if (FPaths::IsRelative(path)) {
-			FString relpath = FPaths::Combine(FPaths::ProjectDir(), path);
-			if (FFileHelper::LoadFileToArray(file_contents, *relpath)) {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Found gesture database file at '%s'"), *relpath);
-			} else {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Could not find gesture database file at '%s'"), *relpath);
-				FString abspath = FPaths::ConvertRelativePathToFull(relpath);
-				if (FFileHelper::LoadFileToArray(file_contents, *abspath)) {
-					UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Found gesture database file at '%s'"), *abspath);
-				} else {
-					UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Could not find gesture database file at '%s'"), *abspath);
-					UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Could not find gesture database file anywhere. Not packaged?"));
+	if (this->TickInWorldSubsystem) {
+		UWorld* world = GetWorld();
+		this->WorldSubsystem = world ? world->GetSubsystem<UMiVRyWorldSubsystem>() : nullptr;
+		if (this->WorldSubsystem != nullptr) {
+			this->WorldSubsystem->registerActor(this);
+		} else {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] MiVRy world subsystem not available, ticking individually."));
+		}
+	}
+
+	const bool from_asset = (this->GestureDatabase != nullptr);
+	const FString path = from_asset ? this->GestureDatabase->GetPathName() : this->GestureDatabaseFile.FilePath;
+	if (this->LoadDatabaseAsynchronously) {
+		// Read and parse the file on a worker thread, then hand the loaded object over on the game thread.
+		this->DatabaseLoading = true;
+		TWeakObjectPtr<AMiVRyActor> weak_this(this);
+		TArray<uint8> asset_contents;
+		if (from_asset) {
+			asset_contents = this->GestureDatabase->Data;
+		}
+		Async(EAsyncExecution::ThreadPool, [weak_this, path, from_asset, file_contents = MoveTemp(asset_contents)]() mutable {
+			GestureRecognition_Result read_result = GestureRecognition_Result::Then;
+			if (!from_asset) {
+				UMiVRyUtil::readFileToBuffer(path, read_result, file_contents);
+			}
+			IGestureRecognition* loaded_gro = nullptr;
+			IGestureCombinations* loaded_gco = nullptr;
+			const int ret = loadDatabase(path, read_result, file_contents, loaded_gro, loaded_gco);
+			AsyncTask(ENamedThreads::GameThread, [weak_this, loaded_gro, loaded_gco, ret]() {
+				AMiVRyActor* self = weak_this.Get();
+				if (self == nullptr) {
+					if (loaded_gro) {
+						GestureRecognition_delete(loaded_gro);
+					}
+					if (loaded_gco) {
+						GestureCombinations_delete(loaded_gco);
+					}
 					return;
 				}
-			}
+				self->finishLoadingDatabase(loaded_gro, loaded_gco, ret);
+			});
+		});
+		return;
+	}
+
+	TArray<uint8> file_contents;
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> shared_contents;
+	GestureRecognition_Result read_result = GestureRecognition_Result::Then;
+	if (!from_asset) {
+		if (this->WorldSubsystem != nullptr) {
+			shared_contents = this->WorldSubsystem->readDatabaseFile(path, read_result);
 		} else {
-			UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Could not find gesture database file anywhere. Not packaged?"));
-			return;
+			UMiVRyUtil::readFileToBuffer(path, read_result, file_contents);
 		}
 	}
+	IGestureRecognition* loaded_gro = nullptr;
+	IGestureCombinations* loaded_gco = nullptr;
+	const int ret = loadDatabase(path, read_result, from_asset ? this->GestureDatabase->Data : (shared_contents.IsValid() ? *shared_contents : file_contents), loaded_gro, loaded_gco);
+	this->finishLoadingDatabase(loaded_gro, loaded_gco, ret);
+}
 
-	// Try one-part/one-hand gesture recognition object
-	this->gro = (IGestureRecognition*)GestureRecognition_create();
-	if (this->gro == nullptr) {
-		UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to create GestureRecognition object"));
-		return;
+int AMiVRyActor::loadDatabase(const FString& path, GestureRecognition_Result read_result, const TArray<uint8>& file_contents, IGestureRecognition*& loaded_gro, IGestureCombinations*& loaded_gco)
+{
+	if (read_result == GestureRecognition_Result::Then) {
+		UE_LOG(LogMiVRy, Display, TEXT("[MiVRyActor] Found gesture database file at '%s'"), *path);
+	} else {
+		UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Could not find gesture database file '%s' anywhere. Not packaged?"), *path);
+		return -3;
 	}
-	int ret = this->gro->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr);
-	if (ret == 0) {
-		UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully loaded gesture database file."));
-		if (this->LicenseName.IsEmpty() == false) {
-			auto license_name = StringCast<ANSICHAR>(*this->LicenseName);
-			auto license_key = StringCast<ANSICHAR>(*this->LicenseKey);
-			ret = this->gro->activateLicense(license_name.Get(), license_key.Get());
-			if (ret == 0) {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully activated license."));
-			} else {
-				const FString errorString = UMiVRyUtil::errorCodeToString(ret);
-				UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
-			}
-		} else if (this->LicenseFilePath.FilePath.IsEmpty() == false) {
-			auto license_file_path = StringCast<ANSICHAR>(*this->LicenseFilePath.FilePath);
-			ret = this->gro->activateLicenseFile(license_file_path.Get());
-			if (ret == 0) {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully activated license."));
-			} else {
-				const FString errorString = UMiVRyUtil::errorCodeToString(ret);
-				UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
+
+	// The content hash tells us the database type if it was loaded (or peeked at) before.
+	const uint64 hash = FMiVRyDatabaseCache::hash(file_contents.GetData(), file_contents.Num());
+	FMiVRyDatabaseInfo cached_info;
+	const bool known_type = FMiVRyDatabaseCache::find(hash, file_contents.Num(), cached_info);
+	int ret = 0;
+
+	if (!known_type || cached_info.Type == GestureRecognition_DatabaseType::GestureRecognition) {
+		// Try one-part/one-hand gesture recognition object
+		loaded_gro = (IGestureRecognition*)GestureRecognition_create();
+		if (loaded_gro == nullptr) {
+			UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Failed to create GestureRecognition object"));
+			return -99;
+		}
+		ret = loaded_gro->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr);
+		if (ret == 0) {
+			if (!known_type) {
+				FMiVRyDatabaseCache::add(hash, file_contents.Num(), loaded_gro);
 			}
+			return 0; // successfully loaded
+		} // else: failed to load
+		GestureRecognition_delete(loaded_gro);
+		loaded_gro = nullptr;
+	}
+
+	// try multi-part gesture combinations object
+	loaded_gco = (IGestureCombinations*)GestureCombinations_create(0);
+	if (loaded_gco == nullptr) {
+		UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Failed to create GestureCombinations object"));
+		return -99;
+	}
+	ret = loaded_gco->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr);
+	if (ret == 0) {
+		if (!known_type) {
+			FMiVRyDatabaseCache::add(hash, file_contents.Num(), loaded_gco);
 		}
-		return; // successfully loaded
+		return 0; // successfully loaded
 	} // else: failed to load
-	delete this->gro;
-	this->gro = nullptr;
+	GestureCombinations_delete(loaded_gco);
+	loaded_gco = nullptr;
+	return ret;
+}
 
-	// try multi-part gesture combinations object
-	this->gco = (IGestureCombinations*)GestureCombinations_create(0);
-	if (this->gco == nullptr) {
-		UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to create GestureCombinations object"));
+void AMiVRyActor::finishLoadingDatabase(IGestureRecognition* loaded_gro, IGestureCombinations* loaded_gco, int ret)
+{
+	this->DatabaseLoading = false;
+	this->AveragePathCache.Empty();
+	this->GestureNames.Reset();
+	this->NumCombinationParts = 0;
+	this->side_enabled[0] = this->side_enabled[1] = true;
+	this->CombinationPartGestures.Reset();
+	this->PartGestureCombinations.Reset();
+	this->CandidateGestures.Empty();
+	this->CandidatePartGestures[0].Empty();
+	this->CandidatePartGestures[1].Empty();
+	this->LastProcessingError = 0;
+	for (int side = 0; side < 2; side++) {
+		this->AppliedContinuousPeriod[side] = -1;
+		this->AppliedContinuousSmoothing[side] = -1;
+	}
+	this->gro = loaded_gro;
+	this->gco = loaded_gco;
+	if (ret != 0) {
+		FString error_str = UMiVRyUtil::errorCodeToString(ret);
+		UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Failed to load gesture database file %s: %s"), this->GestureDatabase ? *this->GestureDatabase->GetPathName() : *this->GestureDatabaseFile.FilePath, *error_str);
+		this->OnDatabaseLoadedDelegate.Broadcast(this, ret);
 		return;
 	}
-	ret = this->gco->loadFromBuffer((const char*)file_contents.GetData(), file_contents.Num(), nullptr);
-	if (ret == 0) {
-		UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully loaded gesture database file."));
-		if (this->LicenseName.IsEmpty() == false) {
-			auto license_name = StringCast<ANSICHAR>(*this->LicenseName);
-			auto license_key = StringCast<ANSICHAR>(*this->LicenseKey);
-			ret = this->gco->activateLicense(license_name.Get(), license_key.Get());
-			if (ret == 0) {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully activated license."));
-			} else {
-				const FString errorString = UMiVRyUtil::errorCodeToString(ret);
-				UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
-			}
-		} else if (this->LicenseFilePath.FilePath.IsEmpty() == false) {
-			auto license_file_path = StringCast<ANSICHAR>(*this->LicenseFilePath.FilePath);
-			ret = this->gro->activateLicenseFile(license_file_path.Get());
-			if (ret == 0) {
-				UE_LOG(LogTemp, Display, TEXT("[MiVRyActor] Successfully activated license."));
-			} else {
-				const FString errorString = UMiVRyUtil::errorCodeToString(ret);
-				UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
+	UE_LOG(LogMiVRy, Display, TEXT("[MiVRyActor] Successfully loaded gesture database file."));
+	if (this->gro) {
+		const int num_gestures = this->gro->numberOfGestures();
+		this->GestureNames.SetNum(num_gestures > 0 ? num_gestures : 0);
+		for (int i = 0; i < num_gestures; i++) {
+			this->GestureNames[i] = this->gro->getGestureName(i);
+		}
+	} else if (this->gco) {
+		const int num_combinations = this->gco->numberOfGestureCombinations();
+		this->GestureNames.SetNum(num_combinations > 0 ? num_combinations : 0);
+		for (int i = 0; i < num_combinations; i++) {
+			this->GestureNames[i] = this->gco->getGestureCombinationName(i);
+		}
+		const int num_parts = this->gco->numberOfParts();
+		this->NumCombinationParts = num_parts > 0 ? num_parts : 0;
+		for (int side = 0; side < 2; side++) {
+			this->side_enabled[side] = (side >= num_parts) || this->gco->getPartEnabled(side);
+		}
+		this->CombinationPartGestures.SetNum(this->GestureNames.Num() * this->NumCombinationParts);
+		for (int i = 0; i < this->GestureNames.Num(); i++) {
+			for (int part = 0; part < this->NumCombinationParts; part++) {
+				const int part_gesture = this->gco->getCombinationPartGesture(i, part);
+				this->CombinationPartGestures[i * this->NumCombinationParts + part] = part_gesture;
+				if (part_gesture >= 0) {
+					this->PartGestureCombinations.Add(((uint64)part << 32) | (uint32)part_gesture, i);
+				}
 			}
 		}
-		return; // successfully loaded
-	} // else: failed to load
-	delete this->gco;
-	this->gco = nullptr;
+	}
+	if (this->LicenseName.IsEmpty() == false) {
+		auto license_name = StringCast<ANSICHAR>(*this->LicenseName);
+		auto license_key = StringCast<ANSICHAR>(*this->LicenseKey);
+		ret = this->gro ? this->gro->activateLicense(license_name.Get(), license_key.Get()) : this->gco->activateLicense(license_name.Get(), license_key.Get());
+		if (ret == 0) {
+			UE_LOG(LogMiVRy, Display, TEXT("[MiVRyActor] Successfully activated license."));
+		} else {
+			const FString errorString = UMiVRyUtil::errorCodeToString(ret);
+			UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
+		}
+	} else if (this->LicenseFilePath.FilePath.IsEmpty() == false) {
+		auto license_file_path = StringCast<ANSICHAR>(*this->LicenseFilePath.FilePath);
+		ret = this->gro ? this->gro->activateLicenseFile(license_file_path.Get()) : this->gco->activateLicenseFile(license_file_path.Get());
+		if (ret == 0) {
+			UE_LOG(LogMiVRy, Display, TEXT("[MiVRyActor] Successfully activated license."));
+		} else {
+			const FString errorString = UMiVRyUtil::errorCodeToString(ret);
+			UE_LOG(LogMiVRy, Error, TEXT("[MiVRyActor] Failed to activate license: %s"), *errorString);
+		}
+	}
+	this->OnDatabaseLoadedDelegate.Broadcast(this, 0);
+}
 
-	FString error_str = UMiVRyUtil::errorCodeToString(ret);
-	UE_LOG(LogTemp, Error, TEXT("[MiVRyActor] Failed to load gesture database file %s: %s"), *this->GestureDatabaseFile.FilePath, *error_str);
+bool AMiVRyActor::IsDatabaseLoading() const
+{
+	return this->DatabaseLoading;
 }
 
 void AMiVRyActor::SetupPlayerInputComponent(class UInputComponent* inputComponent)
 {
 	if (inputComponent == nullptr) {
 		if (!this->LeftTriggerInput.IsNone() || !this->RightTriggerInput.IsNone()) {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Trigger Inputs are set but the actor has no InputComponend. Auto Receive Input setting missing?"));
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Trigger Inputs are set but the actor has no InputComponend. Auto Receive Input setting missing?"));
 		}
 		if (this->LeftTriggerInputAction.IsValid() || this->RightTriggerInputAction.IsValid()) {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Trigger Inputs are set but the actor has no InputComponend. Auto Receive Input setting missing?"));
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Trigger Inputs are set but the actor has no InputComponend. Auto Receive Input setting missing?"));
 		}
 		return;
 	}
@@ -231,13 +335,13 @@ void AMiVRyActor::SetupPlayerInputComponent(class UInputComponent* inputComponen
 		if (BindingPressed.IsValid()) {
 			BindingPressed.bConsumeInput = 0;
 		} else {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *LeftTriggerInput.ToString());
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *LeftTriggerInput.ToString());
 		}
 		auto& BindingReleased = inputComponent->BindAction(this->LeftTriggerInput, IE_Released, this, &AMiVRyActor::LeftTriggerInputReleased);
 		if (BindingReleased.IsValid()) {
 			BindingReleased.bConsumeInput = 0;
 		} else {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *LeftTriggerInput.ToString());
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *LeftTriggerInput.ToString());
 		}
 	}
 	if (!this->RightTriggerInput.IsNone() && this->RightTriggerInput != "") {
@@ -245,13 +349,13 @@ void AMiVRyActor::SetupPlayerInputComponent(class UInputComponent* inputComponen
 		if (BindingPressed.IsValid()) {
 			BindingPressed.bConsumeInput = 0;
 		} else {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *RightTriggerInput.ToString());
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *RightTriggerInput.ToString());
 		}
 		auto& BindingReleased = inputComponent->BindAction(this->RightTriggerInput, IE_Released, this, &AMiVRyActor::RightTriggerInputReleased);
 		if (BindingReleased.IsValid()) {
 			BindingReleased.bConsumeInput = 0;
 		} else {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *RightTriggerInput.ToString());
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Failed to bind input %s"), *RightTriggerInput.ToString());
 		}
 	}
 	UEnhancedInputComponent* enhancedInputComponent = Cast<UEnhancedInputComponent>(inputComponent);
@@ -270,6 +374,53 @@ void AMiVRyActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (this->WorldSubsystem != nullptr) {
+		return; // gathering and processing is done by the world subsystem (actor tick is normally disabled then)
+	}
+
+	// Deliver the results of samples that were processed in the background since the last frame.
+	this->dispatchIdentificationResults();
+
+	TArray<PoseSample> samples;
+	this->gatherFrameSamples(samples);
+	if (samples.Num() == 0) {
+		return;
+	}
+	if (this->ProcessInBackground) {
+		for (const PoseSample& sample : samples) {
+			this->PoseSampleQueue.Enqueue(sample);
+		}
+		if (!this->ProcessingTask.IsValid() || this->ProcessingTask.IsReady()) {
+			this->ProcessingTask = Async(EAsyncExecution::ThreadPool, [this]() {
+				this->processQueuedSamples();
+			});
+		}
+		return;
+	}
+	if (this->ProcessingTask.IsValid()) {
+		this->flushBackgroundProcessing(); // ProcessInBackground was just switched off
+	}
+	for (const PoseSample& sample : samples) {
+		this->processPoseSample(sample);
+	}
+	this->dispatchIdentificationResults();
+}
+
+void AMiVRyActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (this->WorldSubsystem != nullptr) {
+		this->WorldSubsystem->unregisterActor(this);
+		this->WorldSubsystem = nullptr;
+	}
+	if (this->ProcessingTask.IsValid()) {
+		this->ProcessingTask.Wait();
+		this->ProcessingTask = TFuture<void>();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMiVRyActor::gatherPoseSamples(TArray<PoseSample, TInlineAllocator<2>>& samples)
+{
 	USceneComponent* motion_controllers[2];
 	motion_controllers[(uint8)GestureRecognition_Side::Left ] = this->LeftMotionController.Get();
 	motion_controllers[(uint8)GestureRecognition_Side::Right] = this->RightMotionController.Get();
@@ -279,8 +430,13 @@ void AMiVRyActor::Tick(float DeltaTime)
 	EControllerHand controller_hand[2];
 	controller_hand[(uint8)GestureRecognition_Side::Left ] = EControllerHand::Left;
 	controller_hand[(uint8)GestureRecognition_Side::Right] = EControllerHand::Right;
+	const FMiVRyCoordinateConversion& controller_conversion = FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Controller);
+	const FMiVRyCoordinateConversion& headset_conversion = FMiVRyCoordinateConversion::get(this->UnrealVRPlugin, this->MivryCoordinateSystem, GestureRecognition_DeviceType::Headset);
 
 	for (int side = 1; side >= 0; side--) {
+		if (!side_enabled[side]) {
+			continue;
+		}
 		if (!side_active[side] && this->ContinuousGestureRecognition != GestureRecognition_ContinuousIdentification::Always) {
 			continue;
 		}
@@ -302,121 +458,526 @@ void AMiVRyActor::Tick(float DeltaTime)
 			FXRMotionControllerData data;
 			GEngine->XRSystem->GetMotionControllerData(nullptr, controller_hand[side], data);
 			if (data.GripPosition.IsZero()) {
-				UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] unable to track %s controller (device name: '%s')"),
-					(side == (uint8)GestureRecognition_Side::Left ? TEXT("left") : TEXT("right")), *data.DeviceName.ToString());
+				if (!this->ControllerTrackingLost[side]) {
+					this->ControllerTrackingLost[side] = true;
+					UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] unable to track %s controller (device name: '%s')"),
+						(side == (uint8)GestureRecognition_Side::Left ? TEXT("left") : TEXT("right")), *data.DeviceName.ToString());
+				}
 				continue;
 			}
+			if (this->ControllerTrackingLost[side]) {
+				this->ControllerTrackingLost[side] = false;
+				UE_LOG(LogMiVRy, Display, TEXT("[MiVRyActor] tracking %s controller again"),
+					(side == (uint8)GestureRecognition_Side::Left ? TEXT("left") : TEXT("right")));
+			}
 			location = data.GripPosition;
 			rotation = data.GripRotation.Rotator();
 		}
 		FQuat quaternion = rotation.Quaternion();
 
-		double p[3];
-		double q[4];
-		UMiVRyUtil::convertInput(location, quaternion, GestureRecognition_DeviceType::Controller, this->UnrealVRPlugin, this->MivryCoordinateSystem, p, q);
-		double hmd_p[3];
-		double hmd_q[4];
+		PoseSample sample;
+		sample.side = side;
+		sample.time = GetWorld()->GetRealTimeSeconds();
+		sample.compensate_head_motion = this->CompensateHeadMotion;
+		sample.continuous = this->ContinuousGestureRecognition;
+		sample.period = this->ContinuousGesturePeriod;
+		sample.smoothing = this->ContinuousGestureSmoothing;
+		sample.coordinate_system = this->MivryCoordinateSystem;
+		controller_conversion.convertInput(location, quaternion, sample.p, sample.q);
 		if (this->CompensateHeadMotion) {
 			APlayerCameraManager* camManager = GetWorld()->GetFirstPlayerController()->PlayerCameraManager;
 			if (camManager == nullptr) {
-				UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.Tick] Could not get camera position."));
+				if (!this->HeadsetTrackingLost) {
+					this->HeadsetTrackingLost = true;
+					UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.Tick] Could not get camera position."));
+				}
 				return;
 			}
+			this->HeadsetTrackingLost = false;
 			FVector hmd_location = camManager->GetCameraLocation();
 			FRotator hmd_rotation = camManager->GetCameraRotation();
 			FQuat hmd_quaternion = hmd_rotation.Quaternion();
-			UMiVRyUtil::convertInput(hmd_location, hmd_quaternion, GestureRecognition_DeviceType::Headset, this->UnrealVRPlugin, this->MivryCoordinateSystem, hmd_p, hmd_q);
-		}
-		int ret;
-		if (this->gro) {
-			if (this->CompensateHeadMotion) {
-				ret = this->gro->updateHeadPositionQ(hmd_p, hmd_q);
-				if (ret != 0) {
-					UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureRecognition::updateHeadPositionQ() failed with %i"), ret);
+			headset_conversion.convertInput(hmd_location, hmd_quaternion, sample.hmd_p, sample.hmd_q);
+		}
+		samples.Add(sample);
+	}
+}
+
+void AMiVRyActor::gatherFrameSamples(TArray<PoseSample>& samples)
+{
+	if (this->DatabaseLoading) {
+		return;
+	}
+	TArray<PoseSample, TInlineAllocator<2>> gathered;
+	this->gatherPoseSamples(gathered);
+	const int32 first = samples.Num();
+	if (this->SamplingRate > 0) {
+		this->resamplePoseSamples(gathered, samples);
+	} else {
+		samples.Append(gathered);
+	}
+	if (this->gco) {
+		// GestureCombinations identify all parts at once: identify only after the last sample of the frame,
+		// when the strokes of all sides have been updated.
+		bool identify = false;
+		for (int32 i = samples.Num() - 1; i >= first; i--) {
+			if (identify) {
+				samples[i].identify = false;
+			} else {
+				identify = samples[i].identify;
+			}
+		}
+	}
+}
+
+void AMiVRyActor::resamplePoseSamples(const TArray<PoseSample, TInlineAllocator<2>>& samples, TArray<PoseSample>& resampled)
+{
+	const double step = 1.0 / (double)this->SamplingRate;
+	const double max_catch_up = 0.25; // don't try to make up for more than this after a hitch or pause
+	bool gathered[2] = { false, false };
+	for (const PoseSample& sample : samples) {
+		const int side = sample.side;
+		gathered[side] = true;
+		PoseSample& last = this->LastPoseSample[side];
+		if (!this->HasLastPoseSample[side] || sample.time <= last.time) {
+			// First pose of a gesture motion: use as-is and start the fixed-rate clock.
+			resampled.Add(sample);
+			this->NextSampleTime[side] = sample.time + step;
+		} else {
+			this->NextSampleTime[side] = FMath::Max(this->NextSampleTime[side], sample.time - max_catch_up);
+			const int32 first = resampled.Num();
+			for (; this->NextSampleTime[side] <= sample.time; this->NextSampleTime[side] += step) {
+				const double alpha = (this->NextSampleTime[side] - last.time) / (sample.time - last.time);
+				PoseSample& s = resampled.Add_GetRef(sample);
+				s.time = this->NextSampleTime[side];
+				s.identify = false;
+				for (int i = 0; i < 3; i++) {
+					s.p[i] = FMath::Lerp(last.p[i], sample.p[i], alpha);
+					s.hmd_p[i] = FMath::Lerp(last.hmd_p[i], sample.hmd_p[i], alpha);
 				}
+				const FQuat q = FQuat::Slerp(FQuat(last.q[0], last.q[1], last.q[2], last.q[3]), FQuat(sample.q[0], sample.q[1], sample.q[2], sample.q[3]), alpha);
+				s.q[0] = q.X; s.q[1] = q.Y; s.q[2] = q.Z; s.q[3] = q.W;
+				const FQuat hmd_q = FQuat::Slerp(FQuat(last.hmd_q[0], last.hmd_q[1], last.hmd_q[2], last.hmd_q[3]), FQuat(sample.hmd_q[0], sample.hmd_q[1], sample.hmd_q[2], sample.hmd_q[3]), alpha);
+				s.hmd_q[0] = hmd_q.X; s.hmd_q[1] = hmd_q.Y; s.hmd_q[2] = hmd_q.Z; s.hmd_q[3] = hmd_q.W;
 			}
-			ret = this->gro->contdStrokeQ(p, q);
-			if (ret != 0) {
-				UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureRecognition::contdStroke() failed with %i"), ret);
+			if (resampled.Num() > first) {
+				resampled.Last().identify = true; // identify once per frame, after the whole batch
 			}
-			if (this->ContinuousGestureRecognition != GestureRecognition_ContinuousIdentification::Off) {
-				// this->gesture_id = this->gro->contdIdentify(hmd_p, hmd_q, &this->similarity);
-				double pos[3];
-				double scale;
-				double dir0[3];
-				double dir1[3];
-				double dir2[3];
-				this->gesture_id = this->gro->contdIdentifyAndGetStroke(hmd_p, hmd_q, &this->similarity, pos, &scale, dir0, dir1, dir2);
-				if (this->gesture_id < 0) {
-					UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Continuous identification failed with %i"), this->gesture_id);
-				} else {
-					this->parts.SetNum(1);
-					FMiVRyGesturePart& part = this->parts[0];
-					part.Side = (GestureRecognition_Side)side;
-					part.parse(pos, scale, dir0, dir1, dir2, this->MivryCoordinateSystem);
-					this->OnGestureIdentifiedDelegate.Broadcast(
-						this,
-						GestureRecognition_Identification::GestureIdentified,
-						this->gesture_id,
-						this->gro->getGestureName(this->gesture_id),
-						this->similarity,
-						this->parts
-					);
+		}
+		last = sample;
+		this->HasLastPoseSample[side] = true;
+	}
+	for (int side = 0; side < 2; side++) {
+		if (!gathered[side]) {
+			this->HasLastPoseSample[side] = false;
+		}
+	}
+}
+
+/**
+* Track the error state of a recurring (per-frame) operation.
+* @return Whether a new error occurred that was not yet logged.
+*/
+static bool errorStateChanged(int& last_error, int error)
+{
+	if (error == last_error) {
+		return false;
+	}
+	last_error = error;
+	return error != 0;
+}
+
+void AMiVRyActor::applyContinuousSettings(int side, int period, int smoothing)
+{
+	if (this->gro) {
+		if (period != this->AppliedContinuousPeriod[0]) {
+			this->gro->contdIdentificationPeriod = period;
+			this->AppliedContinuousPeriod[0] = period;
+		}
+		if (smoothing != this->AppliedContinuousSmoothing[0]) {
+			this->gro->contdIdentificationSmoothing = smoothing;
+			this->AppliedContinuousSmoothing[0] = smoothing;
+		}
+	} else if (this->gco) {
+		if (period != this->AppliedContinuousPeriod[side]) {
+			this->gco->setContdIdentificationPeriod(side, period);
+			this->AppliedContinuousPeriod[side] = period;
+		}
+		if (smoothing != this->AppliedContinuousSmoothing[side]) {
+			this->gco->setContdIdentificationSmoothing(side, smoothing);
+			this->AppliedContinuousSmoothing[side] = smoothing;
+		}
+	}
+}
+
+void AMiVRyActor::processPoseSample(const PoseSample& sample)
+{
+	FScopeLock lock(&this->ProcessingMutex);
+	const int side = sample.side;
+	int ret;
+	if (this->gro) {
+		if (sample.compensate_head_motion) {
+			ret = this->gro->updateHeadPositionQ(sample.hmd_p, sample.hmd_q);
+			if (errorStateChanged(this->LastHeadPositionError, ret)) {
+				UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureRecognition::updateHeadPositionQ() failed with %i"), ret);
+			}
+		}
+		this->applyContinuousSettings(0, sample.period, sample.smoothing);
+		ret = this->gro->contdStrokeQ(sample.p, sample.q);
+		if (errorStateChanged(this->LastStrokeError[side], ret)) {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureRecognition::contdStroke() failed with %i"), ret);
+		}
+		if (sample.identify && sample.continuous != GestureRecognition_ContinuousIdentification::Off) {
+			IdentificationResult result;
+			double pos[3];
+			double scale;
+			double dir0[3];
+			double dir1[3];
+			double dir2[3];
+			if (this->CandidateGestures.Num() > 0) {
+				int n = this->GestureNames.Num();
+				this->CandidateProbabilities.SetNumUninitialized(n);
+				this->CandidateSimilarities.SetNumUninitialized(n);
+				result.gesture_id = this->gro->contdIdentifyAndGetStrokeAndGetAllProbabilitiesAndSimilarities(sample.hmd_p, sample.hmd_q, this->CandidateProbabilities.GetData(), this->CandidateSimilarities.GetData(), &n, pos, &scale, dir0, dir1, dir2);
+				if (result.gesture_id >= 0) {
+					result.gesture_id = this->identifyCandidateGesture(this->CandidateProbabilities.GetData(), this->CandidateSimilarities.GetData(), n, result.similarity);
 				}
+			} else {
+				result.gesture_id = this->gro->contdIdentifyAndGetStroke(sample.hmd_p, sample.hmd_q, &result.similarity, pos, &scale, dir0, dir1, dir2);
 			}
-		} else if (this->gco) {
-			if (this->CompensateHeadMotion) {
-				ret = this->gco->updateHeadPositionQ(hmd_p, hmd_q);
-				if (ret != 0) {
-					UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureCombinations::updateHeadPositionQ() failed with %i"), ret);
+			if (result.gesture_id < 0) {
+				if (errorStateChanged(this->LastIdentificationError, result.gesture_id)) {
+					UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Continuous identification failed with %i"), result.gesture_id);
 				}
+			} else {
+				errorStateChanged(this->LastIdentificationError, 0);
+				result.parts.SetNum(1);
+				FMiVRyGesturePart& part = result.parts[0];
+				part.Side = (GestureRecognition_Side)side;
+				part.parse(pos, scale, dir0, dir1, dir2, sample.coordinate_system);
 			}
-			this->gco->setContdIdentificationPeriod((int)side, this->ContinuousGesturePeriod);
-			this->gco->setContdIdentificationSmoothing((int)side, this->ContinuousGestureSmoothing);
-			ret = this->gco->contdStrokeQ(side, p, q);
-			if (ret != 0) {
-				UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureCombinations::contdStroke() failed with %i"), ret);
+			this->enqueueIdentificationResult(MoveTemp(result));
+		}
+	} else if (this->gco) {
+		if (sample.compensate_head_motion) {
+			ret = this->gco->updateHeadPositionQ(sample.hmd_p, sample.hmd_q);
+			if (errorStateChanged(this->LastHeadPositionError, ret)) {
+				UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureCombinations::updateHeadPositionQ() failed with %i"), ret);
 			}
-			if (this->ContinuousGestureRecognition != GestureRecognition_ContinuousIdentification::Off) {
-				this->gesture_id = this->gco->contdIdentify(hmd_p, hmd_q, &this->similarity);
-				if (this->gesture_id < 0) {
-					UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Continuous identification failed with %i"), this->gesture_id);
-				} else {
-					const int numParts = this->gco->numberOfParts();
-					this->parts.SetNum(numParts);
-					for (int i = numParts - 1; i >= 0; i--) {
-						FMiVRyGesturePart& part = this->parts[i];
-						part.Side = (GestureRecognition_Side)i;
-						double pos[3];
-						double scale;
-						double dir0[3];
-						double dir1[3];
-						double dir2[3];
-						this->gco->contdIdentifyGetLastStrokeInfo(i, pos, &scale, dir0, dir1, dir2);
-						part.parse(pos, scale, dir0, dir1, dir2, this->MivryCoordinateSystem);
-					}
-					this->OnGestureIdentifiedDelegate.Broadcast(
-						this,
-						GestureRecognition_Identification::GestureIdentified,
-						this->gesture_id,
-						this->gco->getGestureCombinationName(this->gesture_id),
-						this->similarity,
-						this->parts
-					);
+		}
+		this->applyContinuousSettings(side, sample.period, sample.smoothing);
+		ret = this->gco->contdStrokeQ(side, sample.p, sample.q);
+		if (errorStateChanged(this->LastStrokeError[side], ret)) {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureCombinations::contdStroke() failed with %i"), ret);
+		}
+		if (sample.identify && sample.continuous != GestureRecognition_ContinuousIdentification::Off) {
+			IdentificationResult result;
+			result.gesture_id = this->gco->contdIdentify(sample.hmd_p, sample.hmd_q, &result.similarity);
+			if (result.gesture_id >= 0 && this->CandidateGestures.Num() > 0) {
+				// Part probabilities can be outdated for parts which are not gesturing, so only filter MiVRy's result.
+				if (result.gesture_id >= this->CandidateGestures.Num() || !this->CandidateGestures[result.gesture_id]) {
+					result.gesture_id = -1;
 				}
 			}
-		} else {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.Tick] GestureRecognition object was not created. Failed to load database file?"));
+			if (result.gesture_id < 0) {
+				if (errorStateChanged(this->LastIdentificationError, result.gesture_id)) {
+					UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Continuous identification failed with %i"), result.gesture_id);
+				}
+			} else {
+				errorStateChanged(this->LastIdentificationError, 0);
+				const int numParts = this->gco->numberOfParts();
+				result.parts.SetNum(numParts);
+				for (int i = numParts - 1; i >= 0; i--) {
+					FMiVRyGesturePart& part = result.parts[i];
+					part.Side = (GestureRecognition_Side)i;
+					double pos[3];
+					double scale;
+					double dir0[3];
+					double dir1[3];
+					double dir2[3];
+					this->gco->contdIdentifyGetLastStrokeInfo(i, pos, &scale, dir0, dir1, dir2);
+					part.parse(pos, scale, dir0, dir1, dir2, sample.coordinate_system);
+				}
+			}
+			this->enqueueIdentificationResult(MoveTemp(result));
+		}
+	} else if (errorStateChanged(this->LastProcessingError, -99)) {
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.Tick] GestureRecognition object was not created. Failed to load database file?"));
+	}
+}
+
+void AMiVRyActor::processQueuedSamples()
+{
+	PoseSample sample;
+	while (this->PoseSampleQueue.Dequeue(sample)) {
+		this->processPoseSample(sample);
+	}
+}
+
+void AMiVRyActor::enqueueIdentificationResult(IdentificationResult&& result)
+{
+	if (!this->IdentificationResultQueue.Enqueue(MoveTemp(result))) {
+		UE_LOG(LogMiVRy, Verbose, TEXT("[MiVRyActor] Identification result queue is full, dropping result."));
+	}
+}
+
+void AMiVRyActor::dispatchIdentificationResults()
+{
+	IdentificationResult result;
+	while (this->IdentificationResultQueue.Dequeue(result)) {
+		this->gesture_id = result.gesture_id;
+		this->similarity = result.similarity;
+		if (result.gesture_id < 0) {
+			continue;
+		}
+		this->parts.Reset();
+		this->parts.Append(result.parts);
+		this->broadcastGestureIdentified(GestureRecognition_Identification::GestureIdentified);
+	}
+}
+
+const FString& AMiVRyActor::getCachedGestureName(int id) const
+{
+	static const FString empty_name;
+	return this->GestureNames.IsValidIndex(id) ? this->GestureNames[id] : empty_name;
+}
+
+int AMiVRyActor::getCombinationPartGesture(int combination, int part) const
+{
+	if (combination < 0 || part < 0 || part >= this->NumCombinationParts || combination * this->NumCombinationParts >= this->CombinationPartGestures.Num()) {
+		return -1;
+	}
+	return this->CombinationPartGestures[combination * this->NumCombinationParts + part];
+}
+
+void AMiVRyActor::getGestureCombinationsUsingPartGesture(int Part, int PartGestureID, TArray<int>& GestureCombinationIDs) const
+{
+	GestureCombinationIDs.Reset();
+	this->PartGestureCombinations.MultiFind(((uint64)Part << 32) | (uint32)PartGestureID, GestureCombinationIDs);
+}
+
+void AMiVRyActor::setCandidateGestures(GestureRecognition_Result& Result, int& ErrorCode, const TArray<int>& GestureIDs)
+{
+	if (!this->gro && !this->gco) {
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.setCandidateGestures] GestureRecognition object was not created. Failed to load database file?"));
+		ErrorCode = this->DatabaseLoading ? -15 : -99;
+		Result = GestureRecognition_Result::Error;
+		return;
+	}
+	const int num_gestures = this->GestureNames.Num();
+	for (int id : GestureIDs) {
+		if (id < 0 || id >= num_gestures) {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.setCandidateGestures] Invalid gesture ID %i."), id);
+			ErrorCode = -18;
+			Result = GestureRecognition_Result::Error;
+			return;
+		}
+	}
+	this->flushBackgroundProcessing();
+	FScopeLock lock(&this->ProcessingMutex);
+	this->CandidateGestures.Init(false, GestureIDs.Num() > 0 ? num_gestures : 0);
+	this->CandidatePartGestures[0].Empty();
+	this->CandidatePartGestures[1].Empty();
+	for (int id : GestureIDs) {
+		this->CandidateGestures[id] = true;
+		for (int part = 0; part < this->NumCombinationParts && part < 2; part++) {
+			const int part_gesture = this->getCombinationPartGesture(id, part);
+			if (part_gesture < 0) {
+				continue;
+			}
+			TBitArray<>& part_gestures = this->CandidatePartGestures[part];
+			if (part_gesture >= part_gestures.Num()) {
+				part_gestures.Add(false, part_gesture + 1 - part_gestures.Num());
+			}
+			part_gestures[part_gesture] = true;
+		}
+	}
+	ErrorCode = 0;
+	Result = GestureRecognition_Result::Then;
+}
+
+void AMiVRyActor::clearCandidateGestures()
+{
+	this->flushBackgroundProcessing();
+	FScopeLock lock(&this->ProcessingMutex);
+	this->CandidateGestures.Empty();
+	this->CandidatePartGestures[0].Empty();
+	this->CandidatePartGestures[1].Empty();
+}
+
+void AMiVRyActor::getCandidateGestures(TArray<int>& GestureIDs) const
+{
+	GestureIDs.Reset();
+	for (TConstSetBitIterator<> it(this->CandidateGestures); it; ++it) {
+		GestureIDs.Add(it.GetIndex());
+	}
+}
+
+int AMiVRyActor::identifyCandidateGesture(const double* p, const double* s, int n, double& sim) const
+{
+	// Renormalizing the probabilities over the candidates does not change which one is the most probable,
+	// so picking the maximum among the candidates is sufficient.
+	int best_id = -1;
+	double best_p = -1.0;
+	for (TConstSetBitIterator<> it(this->CandidateGestures); it && it.GetIndex() < n; ++it) {
+		const int id = it.GetIndex();
+		if (p[id] > best_p) {
+			best_p = p[id];
+			best_id = id;
 		}
 	}
+	sim = (best_id >= 0) ? s[best_id] : -1.0;
+	return best_id;
+}
+
+int AMiVRyActor::identifyCandidateCombination(int identified_id, double& sim)
+{
+	// Part probabilities are stored consecutively for each part, starting at part_offset[part].
+	int part_offset[2] = { 0, 0 };
+	int part_count[2] = { 0, 0 };
+	int total = 0;
+	for (int part = 0; part < this->NumCombinationParts && part < 2; part++) {
+		part_offset[part] = total;
+		if (this->side_enabled[part] && this->CandidatePartGestures[part].Num() > 0) {
+			const int num_gestures = this->gco->numberOfGestures(part);
+			part_count[part] = num_gestures > 0 ? num_gestures : 0;
+			total += part_count[part];
+		}
+	}
+	this->CandidateProbabilities.SetNumUninitialized(total);
+	this->CandidateSimilarities.SetNumUninitialized(total);
+	// Renormalize the part probabilities over the part gestures used by the candidates.
+	double part_sum[2] = { 0, 0 };
+	for (int part = 0; part < this->NumCombinationParts && part < 2; part++) {
+		if (part_count[part] <= 0) {
+			continue;
+		}
+		const int ret = this->gco->getPartProbabilitiesAndSimilarities(part, &this->CandidateProbabilities[part_offset[part]], &this->CandidateSimilarities[part_offset[part]], &part_count[part]);
+		if (ret < 0) {
+			return ret;
+		}
+		for (TConstSetBitIterator<> it(this->CandidatePartGestures[part]); it && it.GetIndex() < part_count[part]; ++it) {
+			part_sum[part] += this->CandidateProbabilities[part_offset[part] + it.GetIndex()];
+		}
+	}
+	// Rank the candidates by the geometric mean of their part probabilities,
+	// so that combinations with fewer parts are compared on the same scale.
+	int best_id = -1;
+	double best_score = -1.0;
+	double best_sim = -1.0;
+	auto score_candidate = [&](int id) {
+		double p = 1.0;
+		double s = 0.0;
+		int num_used_parts = 0;
+		for (int part = 0; part < this->NumCombinationParts && part < 2; part++) {
+			const int part_gesture = this->getCombinationPartGesture(id, part);
+			if (part_gesture < 0 || !this->side_enabled[part]) {
+				continue;
+			}
+			num_used_parts++;
+			if (part_gesture >= part_count[part] || part_sum[part] <= 0) {
+				p = 0.0;
+				continue;
+			}
+			p *= this->CandidateProbabilities[part_offset[part] + part_gesture] / part_sum[part];
+			s += this->CandidateSimilarities[part_offset[part] + part_gesture];
+		}
+		if (num_used_parts == 0) {
+			return;
+		}
+		const double score = FMath::Pow(p, 1.0 / num_used_parts);
+		if (score > best_score) {
+			best_score = score;
+			best_id = id;
+			best_sim = s / num_used_parts;
+		}
+	};
+	// Candidates whose part gestures are all unlikely score below MinCandidatePartProbability,
+	// so first only score the candidates found through the likely part gestures.
+	TBitArray<> scored(false, this->CandidateGestures.Num());
+	for (int part = 0; part < this->NumCombinationParts && part < 2; part++) {
+		if (part_count[part] <= 0 || part_sum[part] <= 0) {
+			continue;
+		}
+		for (TConstSetBitIterator<> it(this->CandidatePartGestures[part]); it && it.GetIndex() < part_count[part]; ++it) {
+			const int part_gesture = it.GetIndex();
+			if (this->CandidateProbabilities[part_offset[part] + part_gesture] / part_sum[part] < MinCandidatePartProbability) {
+				continue;
+			}
+			for (auto combination = this->PartGestureCombinations.CreateConstKeyIterator(((uint64)part << 32) | (uint32)part_gesture); combination; ++combination) {
+				const int id = combination.Value();
+				if (id < this->CandidateGestures.Num() && this->CandidateGestures[id] && !scored[id]) {
+					scored[id] = true;
+					score_candidate(id);
+				}
+			}
+		}
+	}
+	if (best_score < MinCandidatePartProbability) {
+		// A skipped candidate could still score higher: rank all candidates.
+		for (TConstSetBitIterator<> it(this->CandidateGestures); it; ++it) {
+			score_candidate(it.GetIndex());
+		}
+	}
+	if (best_id != identified_id) {
+		sim = best_sim; // otherwise keep MiVRy's own similarity of the identified combination
+	}
+	return best_id;
+}
+
+const AMiVRyActor::GestureEvent* AMiVRyActor::getGestureEvent(uint32 counter) const
+{
+	if (counter == 0 || counter > this->GestureEventCounter || this->GestureEventCounter - counter >= GestureEventHistorySize) {
+		return nullptr;
+	}
+	return &this->GestureEvents[counter % GestureEventHistorySize];
+}
+
+void AMiVRyActor::broadcastGestureIdentified(GestureRecognition_Identification Result)
+{
+	static const TArray<FMiVRyGesturePart> no_parts;
+	const bool identified = (Result == GestureRecognition_Identification::GestureIdentified);
+	const int id = identified ? this->gesture_id : -1;
+	const FString& name = this->getCachedGestureName(id);
+	const float sim = identified ? (float)this->similarity : -1.0f;
+	const TArray<FMiVRyGesturePart>& gesture_parts = identified ? this->parts : no_parts;
+	this->GestureEventCounter++;
+	GestureEvent& event = this->GestureEvents[this->GestureEventCounter % GestureEventHistorySize];
+	event.result = Result;
+	event.gesture_id = id;
+	event.similarity = sim;
+	event.parts.Reset();
+	event.parts.Append(gesture_parts);
+	this->OnGestureIdentifiedNative.Broadcast(this, Result, id, name, sim, gesture_parts);
+	if (this->OnGestureIdentifiedDelegate.IsBound()) {
+		this->OnGestureIdentifiedDelegate.Broadcast(this, Result, id, name, sim, gesture_parts);
+	}
+}
+
+void AMiVRyActor::flushBackgroundProcessing()
+{
+	if (this->ProcessingTask.IsValid()) {
+		this->ProcessingTask.Wait();
+		this->ProcessingTask = TFuture<void>();
+	}
+	// Samples queued after the task finished draining the queue.
+	this->processQueuedSamples();
+	this->dispatchIdentificationResults();
 }
 
 void AMiVRyActor::startGesturing(GestureRecognition_Result& Result, int& ErrorCode, GestureRecognition_Side side)
 {
+	this->flushBackgroundProcessing();
+	if (this->DatabaseLoading) {
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.startGesturing] Gesture database file is still loading."));
+		ErrorCode = -15;
+		Result = GestureRecognition_Result::Error;
+		return;
+	}
 	APlayerCameraManager* camManager = GetWorld()->GetFirstPlayerController()->PlayerCameraManager;
 	if (camManager == nullptr) {
 		Result = GestureRecognition_Result::Error;
-		UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.startGesturing] Could not get camera position."));
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.startGesturing] Could not get camera position."));
 		return;
 	}
 	FVector location = camManager->GetCameraLocation();
@@ -426,8 +987,7 @@ void AMiVRyActor::startGesturing(GestureRecognition_Result& Result, int& ErrorCo
 	double q[4];
 	UMiVRyUtil::convertInput(location, quaternion, GestureRecognition_DeviceType::Headset, this->UnrealVRPlugin, this->MivryCoordinateSystem, p, q);
 	if (this->gro) {
-		this->gro->contdIdentificationPeriod = this->ContinuousGesturePeriod;
-		this->gro->contdIdentificationSmoothing = this->ContinuousGestureSmoothing;
+		this->applyContinuousSettings(0, this->ContinuousGesturePeriod, this->ContinuousGestureSmoothing);
 		ErrorCode = this->gro->startStroke(p, q, -1);
 		if (ErrorCode != 0) {
 			Result = GestureRecognition_Result::Error;
@@ -438,6 +998,12 @@ void AMiVRyActor::startGesturing(GestureRecognition_Result& Result, int& ErrorCo
 		return;
 	}
 	if (this->gco) {
+		if (!this->side_enabled[(uint8)side]) {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.startGesturing] Side %i is disabled (see setPartEnabled)."), (int)side);
+			ErrorCode = -18;
+			Result = GestureRecognition_Result::Error;
+			return;
+		}
 		ErrorCode = this->gco->startStroke((int)side, p, q, -1);
 		if (ErrorCode != 0) {
 			Result = GestureRecognition_Result::Error;
@@ -448,7 +1014,7 @@ void AMiVRyActor::startGesturing(GestureRecognition_Result& Result, int& ErrorCo
 		return;
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.startGesturing] GestureRecognition object was not created. Failed to load database file?"));
+	UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.startGesturing] GestureRecognition object was not created. Failed to load database file?"));
 	ErrorCode = -99;
 	Result = GestureRecognition_Result::Error;
 }
@@ -458,8 +1024,42 @@ bool AMiVRyActor::IsGesturing(GestureRecognition_Side side)
 	return this->side_active[(uint8)side];
 }
 
+bool AMiVRyActor::getPartEnabled(GestureRecognition_Side side) const
+{
+	return this->side_enabled[(uint8)side];
+}
+
+void AMiVRyActor::setPartEnabled(GestureRecognition_Result& Result, int& ErrorCode, GestureRecognition_Side side, bool enabled)
+{
+	this->flushBackgroundProcessing();
+	FScopeLock lock(&this->ProcessingMutex);
+	if (!this->gco) {
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.setPartEnabled] Only GestureCombinations databases have parts that can be enabled or disabled."));
+		ErrorCode = this->gro ? -18 : -99;
+		Result = GestureRecognition_Result::Error;
+		return;
+	}
+	ErrorCode = this->gco->setPartEnabled((int)side, enabled);
+	if (ErrorCode != 0) {
+		Result = GestureRecognition_Result::Error;
+		return;
+	}
+	this->side_enabled[(uint8)side] = enabled;
+	this->HasLastPoseSample[(uint8)side] = false;
+	if (!enabled) {
+		// End the side's gesture (if any), so that the other side does not wait for it.
+		if (this->side_active[(uint8)side]) {
+			this->gco->cancelStroke((int)side);
+			this->side_active[(uint8)side] = false;
+		}
+		this->parts.RemoveAll([side](const FMiVRyGesturePart& part) { return part.Side == side; });
+	}
+	Result = GestureRecognition_Result::Then;
+}
+
 void AMiVRyActor::stopGesturing(GestureRecognition_Identification& Result, GestureRecognition_Side side)
 {
+	this->flushBackgroundProcessing();
 	this->side_active[(uint8)side] = false;
 	if (this->gro) {
 		double pos[3];
@@ -467,15 +1067,25 @@ void AMiVRyActor::stopGesturing(GestureRecognition_Identification& Result, Gestu
 		double dir0[3];
 		double dir1[3];
 		double dir2[3];
-		this->gesture_id = this->gro->endStrokeAndGetSimilarity(&this->similarity, pos, &scale, dir0, dir1, dir2);
+		if (this->CandidateGestures.Num() > 0) {
+			int n = this->GestureNames.Num();
+			this->CandidateProbabilities.SetNumUninitialized(n);
+			this->CandidateSimilarities.SetNumUninitialized(n);
+			this->gesture_id = this->gro->endStrokeAndGetAllProbabilitiesAndSimilarities(this->CandidateProbabilities.GetData(), this->CandidateSimilarities.GetData(), &n, pos, &scale, dir0, dir1, dir2);
+			if (this->gesture_id >= 0) {
+				this->gesture_id = this->identifyCandidateGesture(this->CandidateProbabilities.GetData(), this->CandidateSimilarities.GetData(), n, this->similarity);
+			}
+		} else {
+			this->gesture_id = this->gro->endStrokeAndGetSimilarity(&this->similarity, pos, &scale, dir0, dir1, dir2);
+		}
 		if (this->gesture_id < 0) {
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] Identification failed with %i"), this->gesture_id);
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] Identification failed with %i"), this->gesture_id);
 			Result = GestureRecognition_Identification::FailedToIdentify;
 			this->parts.SetNum(1);
 			FMiVRyGesturePart& part = this->parts[0];
 			part.Side = side;
 			part.PartGestureID = -1;
-			this->OnGestureIdentifiedDelegate.Broadcast(this, Result, -1, "", -1, TArray<FMiVRyGesturePart>());
+			this->broadcastGestureIdentified(Result);
 			return;
 		}
 		this->parts.SetNum(1);
@@ -484,21 +1094,15 @@ void AMiVRyActor::stopGesturing(GestureRecognition_Identification& Result, Gestu
 		part.PartGestureID = this->gesture_id;
 		part.parse(pos, scale, dir0, dir1, dir2, this->MivryCoordinateSystem);
 		Result = GestureRecognition_Identification::GestureIdentified;
-
-		GestureRecognition_Result Result2;
-		int GestureID = -1;
-		FString GestureName = "";
-		float Similarity = -1;
-		TArray<FMiVRyGesturePart> GestureParts;
-		this->getIdentifiedGestureInfo(Result2, GestureID, GestureName, Similarity, GestureParts);
-		this->OnGestureIdentifiedDelegate.Broadcast(
-			this,
-			GestureRecognition_Identification::GestureIdentified,
-			GestureID, GestureName, Similarity, GestureParts);
-
+		this->broadcastGestureIdentified(Result);
 		return;
 	}
 	if (this->gco) {
+		if (!this->side_enabled[(uint8)side]) {
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.stopGesturing] Side %i is disabled (see setPartEnabled)."), (int)side);
+			Result = GestureRecognition_Identification::FailedToIdentify;
+			return;
+		}
 		double pos[3];
 		double scale;
 		double dir0[3];
@@ -507,7 +1111,7 @@ void AMiVRyActor::stopGesturing(GestureRecognition_Identification& Result, Gestu
 		int ret = this->gco->endStroke((int)side, pos, &scale, dir0, dir1, dir2);
 		if (ret < 0) {
 			Result = GestureRecognition_Identification::FailedToIdentify;
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureCombinations::endStroke() failed with %i"), ret);
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureCombinations::endStroke() failed with %i"), ret);
 			return;
 		}
 		FMiVRyGesturePart* part = nullptr;
@@ -523,43 +1127,37 @@ void AMiVRyActor::stopGesturing(GestureRecognition_Identification& Result, Gestu
 			part->Side = side;
 		}
 		part->parse(pos, scale, dir0, dir1, dir2, this->MivryCoordinateSystem);
-		if (this->side_active[1 - (uint8)side]) {
+		if (this->side_active[1 - (uint8)side] && this->side_enabled[1 - (uint8)side]) {
 			Result = GestureRecognition_Identification::WaitingForOtherHand;
 			return;
 		}
 		this->gesture_id = this->gco->identifyGestureCombination(nullptr, &this->similarity);
+		if (this->gesture_id >= 0 && this->CandidateGestures.Num() > 0) {
+			this->gesture_id = this->identifyCandidateCombination(this->gesture_id, this->similarity);
+		}
 		if (this->gesture_id < 0) {
 			Result = GestureRecognition_Identification::FailedToIdentify;
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor] GestureCombinations::identifyGestureCombination() failed with %i"), this->gesture_id);
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor] GestureCombinations::identifyGestureCombination() failed with %i"), this->gesture_id);
 			for (int i = 0; i < parts.Num(); i++) {
 				parts[i].PartGestureID = -1;
 			}
-			this->OnGestureIdentifiedDelegate.Broadcast(this, Result, -1, "", -1, TArray<FMiVRyGesturePart>());
+			this->broadcastGestureIdentified(Result);
 			return;
 		}
 		for (int i = 0; i < parts.Num(); i++) {
-			parts[i].PartGestureID = this->gco->getCombinationPartGesture(this->gesture_id, (int)parts[i].Side);
+			parts[i].PartGestureID = this->getCombinationPartGesture(this->gesture_id, (int)parts[i].Side);
 		}
 		Result = GestureRecognition_Identification::GestureIdentified;
-		GestureRecognition_Result Result2;
-		int GestureID = -1;
-		FString GestureName = "";
-		float Similarity = -1;
-		TArray<FMiVRyGesturePart> GestureParts;
-		this->getIdentifiedGestureInfo(Result2, GestureID, GestureName, Similarity, GestureParts);
-		this->OnGestureIdentifiedDelegate.Broadcast(
-			this,
-			GestureRecognition_Identification::GestureIdentified,
-			GestureID, GestureName, Similarity, GestureParts
-		);
+		this->broadcastGestureIdentified(Result);
 		return;
 	}
-	UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.stopGesturing] GestureRecognition object was not created. Failed to load database file?"));
+	UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.stopGesturing] GestureRecognition object was not created. Failed to load database file?"));
 	Result = GestureRecognition_Identification::FailedToIdentify;
 }
 
 void AMiVRyActor::getIdentifiedGestureInfo(GestureRecognition_Result& Result, int& GestureID, FString& GestureName, float& Similarity, TArray<FMiVRyGesturePart>& GestureParts) const
 {
+	FScopeLock lock(&this->ProcessingMutex);
 	GestureID = this->gesture_id;
 	Similarity = (float)this->similarity;
 	GestureParts = this->parts;
@@ -567,14 +1165,11 @@ void AMiVRyActor::getIdentifiedGestureInfo(GestureRecognition_Result& Result, in
 		Result = GestureRecognition_Result::Error;
 		return;
 	}
-	if (this->gro) {
-		GestureName = this->gro->getGestureName(GestureID);
-		Result = GestureRecognition_Result::Then;
-	} else if (this->gco) {
-		GestureName = this->gco->getGestureCombinationName(GestureID);
+	if (this->gro || this->gco) {
+		GestureName = this->getCachedGestureName(GestureID);
 		Result = GestureRecognition_Result::Then;
 	} else {
-		UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.getIdentifiedGestureInfo] GestureRecognition object was not created. Failed to load database file?"));
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.getIdentifiedGestureInfo] GestureRecognition object was not created. Failed to load database file?"));
 		GestureName = "";
 		Result = GestureRecognition_Result::Error;
 	}
@@ -589,134 +1184,103 @@ void AMiVRyActor::getGesturePartAveragePath(const FMiVRyGesturePart& part, Gestu
 	GestureRotation = FRotator::ZeroRotator;
 	GestureScale = 1.0f;
 	Result = GestureRecognition_Result::Error;
-	if (this->gro) {
-		const int mean_len = this->gro->getGestureMeanLength(part.PartGestureID);
-		if (mean_len <= 0) {
-			return;
-		}
-		double* p = new double[3 * mean_len];
-		double* q = new double[4 * mean_len];
-		double hmd_p[3];
-		double hmd_q[4];
-		double scale;
-		const int ret = this->gro->getGestureMeanStroke(part.PartGestureID, (double(*)[3])p, (double(*)[4])q, mean_len, hmd_p, hmd_q, &scale);
-		if (ret <= 0) {
-			delete[] p;
-			delete[] q;
-			return;
-		}
-		FQuat quat;
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, hmd_p, hmd_q, GestureRecognition_DeviceType::Headset, GestureLocation, quat);
-		GestureRotation = quat.Rotator();
-		GestureScale = (float)scale;
-		switch (this->MivryCoordinateSystem) {
-		case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-			GestureScale *= 100.0f;
-		}
-		const int len = (ret < mean_len) ? ret : mean_len;
-		Locations.SetNum(len);
-		Rotations.SetNum(len);
-		for (int i = 0; i < len; i++) {
-			Locations[i].X = (float)p[3 * i + 0]; // x = primart axis
-			Locations[i].Y = (float)p[3 * i + 1]; // y = secondary axis
-			Locations[i].Z = (float)p[3 * i + 2]; // z = least-significant axis
-			quat.X = (float)q[4 * i + 0];
-			quat.Y = (float)q[4 * i + 1];
-			quat.Z = (float)q[4 * i + 2];
-			quat.W = (float)q[4 * i + 3];
-			quat.Normalize();
-			switch (this->MivryCoordinateSystem) {
-			case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-			case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-			case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-				const FVector xaxis = quat.GetAxisX();
-				const FVector yaxis = quat.GetAxisY();
-				const FVector zaxis = quat.GetAxisZ();
-				FRotationMatrix m(FRotator::ZeroRotator);
-				m.M[0][0] = -yaxis.Z;
-				m.M[0][1] = -yaxis.X;
-				m.M[0][2] = -yaxis.Y;
-				m.M[1][0] = xaxis.Z;
-				m.M[1][1] = xaxis.X;
-				m.M[1][2] = xaxis.Y;
-				m.M[2][0] = zaxis.Z;
-				m.M[2][1] = zaxis.X;
-				m.M[2][2] = zaxis.Y;
-				quat = m.ToQuat();
-			}
-			Rotations[i] = quat.Rotator();
-		}
-		delete[] p;
-		delete[] q;
-		Result = GestureRecognition_Result::Then;
+	FScopeLock lock(&this->ProcessingMutex);
+	if (!this->gro && !this->gco) {
+		UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.getGesturePartStroke] GestureRecognition object was not created. Failed to load database file?"));
 		return;
-	} else if (this->gco) {
-		int mean_len = this->gco->getGestureMeanLength((int)part.Side, part.PartGestureID);
-		if (mean_len <= 0)
-			return;
-		double* p = new double[3 * mean_len];
-		double* q = new double[4 * mean_len];
-		double hmd_p[3];
-		double hmd_q[4];
-		double scale;
-		int ret = this->gco->getGestureMeanStroke((int)part.Side, part.PartGestureID, (double(*)[3])p, (double(*)[4])q, mean_len, hmd_p, hmd_q, &scale);
-		if (ret < 0) {
-			delete[] p;
-			delete[] q;
+	}
+	if (this->AveragePathCacheVRPlugin != this->UnrealVRPlugin || this->AveragePathCacheCoordinateSystem != this->MivryCoordinateSystem) {
+		this->AveragePathCache.Empty();
+		this->AveragePathCacheVRPlugin = this->UnrealVRPlugin;
+		this->AveragePathCacheCoordinateSystem = this->MivryCoordinateSystem;
+	}
+	const uint64 key = (this->gro ? 0 : ((uint64)part.Side << 32)) | (uint32)part.PartGestureID;
+	const AveragePath* path = this->AveragePathCache.Find(key);
+	if (path == nullptr) {
+		AveragePath new_path;
+		if (!this->buildGesturePartAveragePath(part, new_path)) {
 			return;
 		}
-		FQuat quat;
-		UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, hmd_p, hmd_q, GestureRecognition_DeviceType::Headset, GestureLocation, quat);
-		GestureRotation = quat.Rotator();
-		GestureScale = (float)scale;
-		switch (this->MivryCoordinateSystem) {
-		case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-			GestureScale *= 100.0f;
-		}
-		const int len = (ret < mean_len) ? ret : mean_len;
-		Locations.SetNum(len);
-		Rotations.SetNum(len);
-		for (int i = 0; i < len; i++) {
-			Locations[i].X = (float)p[3 * i + 0]; // x = primart axis
-			Locations[i].Y = (float)p[3 * i + 1]; // y = secondary axis
-			Locations[i].Z = (float)p[3 * i + 2]; // z = least-significant axis
-			quat.X = (float)q[4 * i + 0];
-			quat.Y = (float)q[4 * i + 1];
-			quat.Z = (float)q[4 * i + 2];
-			quat.W = (float)q[4 * i + 3];
-			quat.Normalize();
-			switch (this->MivryCoordinateSystem) {
-			case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-			case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-			case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-				const FVector xaxis = quat.GetAxisX();
-				const FVector yaxis = quat.GetAxisY();
-				const FVector zaxis = quat.GetAxisZ();
-				FRotationMatrix m(FRotator::ZeroRotator);
-				m.M[0][0] = -yaxis.Z;
-				m.M[0][1] = -yaxis.X;
-				m.M[0][2] = -yaxis.Y;
-				m.M[1][0] = xaxis.Z;
-				m.M[1][1] = xaxis.X;
-				m.M[1][2] = xaxis.Y;
-				m.M[2][0] = zaxis.Z;
-				m.M[2][1] = zaxis.X;
-				m.M[2][2] = zaxis.Y;
-				quat = m.ToQuat();
-			}
-			Rotations[i] = quat.Rotator();
-		}
-		delete[] p;
-		delete[] q;
-		Result = GestureRecognition_Result::Then;
-		return;
+		path = &this->AveragePathCache.Add(key, MoveTemp(new_path));
+	}
+	Locations = path->Locations;
+	Rotations = path->Rotations;
+	GestureLocation = path->GestureLocation;
+	GestureRotation = path->GestureRotation;
+	GestureScale = path->GestureScale;
+	Result = GestureRecognition_Result::Then;
+}
+
+bool AMiVRyActor::buildGesturePartAveragePath(const FMiVRyGesturePart& part, AveragePath& path) const
+{
+	int mean_len;
+	if (this->gro) {
+		mean_len = this->gro->getGestureMeanLength(part.PartGestureID);
+	} else {
+		mean_len = this->gco->getGestureMeanLength((int)part.Side, part.PartGestureID);
+	}
+	if (mean_len <= 0) {
+		return false;
+	}
+	TArray<double> p;
+	TArray<double> q;
+	p.SetNumUninitialized(3 * mean_len);
+	q.SetNumUninitialized(4 * mean_len);
+	double hmd_p[3];
+	double hmd_q[4];
+	double scale;
+	int ret;
+	if (this->gro) {
+		ret = this->gro->getGestureMeanStroke(part.PartGestureID, (double(*)[3])p.GetData(), (double(*)[4])q.GetData(), mean_len, hmd_p, hmd_q, &scale);
 	} else {
-		UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.getGesturePartStroke] GestureRecognition object was not created. Failed to load database file?"));
+		ret = this->gco->getGestureMeanStroke((int)part.Side, part.PartGestureID, (double(*)[3])p.GetData(), (double(*)[4])q.GetData(), mean_len, hmd_p, hmd_q, &scale);
+	}
+	if (ret < 0 || (ret == 0 && this->gro)) {
+		return false;
+	}
+	FQuat quat;
+	UMiVRyUtil::convertOutput(this->UnrealVRPlugin, this->MivryCoordinateSystem, hmd_p, hmd_q, GestureRecognition_DeviceType::Headset, path.GestureLocation, quat);
+	path.GestureRotation = quat.Rotator();
+	path.GestureScale = (float)scale;
+	bool unity = false;
+	switch (this->MivryCoordinateSystem) {
+	case GestureRecognition_CoordinateSystem::Unity_OculusVR:
+	case GestureRecognition_CoordinateSystem::Unity_OpenXR:
+	case GestureRecognition_CoordinateSystem::Unity_SteamVR:
+		path.GestureScale *= 100.0f;
+		unity = true;
+	}
+	const int len = (ret < mean_len) ? ret : mean_len;
+	path.Locations.SetNum(len);
+	path.Rotations.SetNum(len);
+	for (int i = 0; i < len; i++) {
+		path.Locations[i].X = (float)p[3 * i + 0]; // x = primart axis
+		path.Locations[i].Y = (float)p[3 * i + 1]; // y = secondary axis
+		path.Locations[i].Z = (float)p[3 * i + 2]; // z = least-significant axis
+		quat.X = (float)q[4 * i + 0];
+		quat.Y = (float)q[4 * i + 1];
+		quat.Z = (float)q[4 * i + 2];
+		quat.W = (float)q[4 * i + 3];
+		quat.Normalize();
+		if (unity) {
+			const FVector xaxis = quat.GetAxisX();
+			const FVector yaxis = quat.GetAxisY();
+			const FVector zaxis = quat.GetAxisZ();
+			FRotationMatrix m(FRotator::ZeroRotator);
+			m.M[0][0] = -yaxis.Z;
+			m.M[0][1] = -yaxis.X;
+			m.M[0][2] = -yaxis.Y;
+			m.M[1][0] = xaxis.Z;
+			m.M[1][1] = xaxis.X;
+			m.M[1][2] = xaxis.Y;
+			m.M[2][0] = zaxis.Z;
+			m.M[2][1] = zaxis.X;
+			m.M[2][2] = zaxis.Y;
+			quat = m.ToQuat();
+		}
+		path.Rotations[i] = quat.Rotator();
 	}
+	return true;
 }
 
 
@@ -750,7 +1314,7 @@ void AMiVRyActor::RightTriggerInputReleased()
 void AMiVRyActor::EnhancedInputLeftTrigger(const FInputActionValue& Value)
 {
 	float v = EnhancedInputTriggerValue(Value);
-	UE_LOG(LogTemp, Warning, TEXT("EnhancedInputLeftTrigger %f"), v);
+	UE_LOG(LogMiVRy, VeryVerbose, TEXT("[MiVRyActor] EnhancedInputLeftTrigger %f"), v);
 	if (this->side_active[(uint8)GestureRecognition_Side::Left]) {
 		// currently gesturing
 		if (v < this->LeftTriggerInputThreshold) {
@@ -767,7 +1331,7 @@ void AMiVRyActor::EnhancedInputLeftTrigger(const FInputActionValue& Value)
 void AMiVRyActor::EnhancedInputRightTrigger(const FInputActionValue& Value)
 {
 	float v = EnhancedInputTriggerValue(Value);
-	UE_LOG(LogTemp, Warning, TEXT("EnhancedInputRightTrigger %f"), v);
+	UE_LOG(LogMiVRy, VeryVerbose, TEXT("[MiVRyActor] EnhancedInputRightTrigger %f"), v);
 	if (this->side_active[(uint8)GestureRecognition_Side::Right]) {
 		// currently gesturing
 		if (v < this->RightTriggerInputThreshold) {
@@ -798,7 +1362,7 @@ float AMiVRyActor::EnhancedInputTriggerValue(const FInputActionValue& Value)
 			return Value.Get<FInputActionValue::Axis3D>().Size(); // FInputActionValue::Axis3D == FVector
 			break;
 		default:
-			UE_LOG(LogTemp, Warning, TEXT("[MiVRyActor.EnhancedInputLeftTrigger] Unkown value type."));
+			UE_LOG(LogMiVRy, Warning, TEXT("[MiVRyActor.EnhancedInputLeftTrigger] Unkown value type."));
 			return 0.0;
 	}
 }
@@ -0,0 +1,149 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MiVRyDatabaseCache.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeLock.h"
+#include "GestureRecognition.h"
+#include "GestureCombinations.h"
+
+FCriticalSection FMiVRyDatabaseCache::Mutex;
+TMap<uint64, FMiVRyDatabaseCache::Entry> FMiVRyDatabaseCache::Entries;
+uint64 FMiVRyDatabaseCache::UseCounter = 0;
+
+uint64 FMiVRyDatabaseCache::hash(const uint8* Data, int64 Size)
+{
+	return CityHash64((const char*)Data, (uint32)FMath::Clamp<int64>(Size, 0, MAX_uint32));
+}
+
+bool FMiVRyDatabaseCache::find(uint64 Hash, int64 Size, FMiVRyDatabaseInfo& Info)
+{
+	FScopeLock Lock(&Mutex);
+	Entry* Found = Entries.Find(Hash);
+	if (Found == nullptr || Found->Size != Size) {
+		return false;
+	}
+	Found->LastUsed = ++UseCounter;
+	Info = Found->Info;
+	return true;
+}
+
+bool FMiVRyDatabaseCache::get(const TArray<uint8>& Data, FMiVRyDatabaseInfo& Info)
+{
+	const uint64 Hash = hash(Data.GetData(), Data.Num());
+	if (find(Hash, Data.Num(), Info)) {
+		return true;
+	}
+
+	// Try one-part/one-hand gesture recognition object
+	IGestureRecognition* gro = (IGestureRecognition*)GestureRecognition_create();
+	if (gro != nullptr) {
+		const bool Loaded = (gro->loadFromBuffer((const char*)Data.GetData(), Data.Num(), nullptr) == 0);
+		if (Loaded) {
+			add(Hash, Data.Num(), gro);
+		}
+		delete gro;
+		if (Loaded) {
+			return find(Hash, Data.Num(), Info);
+		}
+	}
+
+	// Try multi-part gesture combinations object
+	IGestureCombinations* gco = (IGestureCombinations*)GestureCombinations_create(0);
+	if (gco != nullptr) {
+		const bool Loaded = (gco->loadFromBuffer((const char*)Data.GetData(), Data.Num(), nullptr) == 0);
+		if (Loaded) {
+			add(Hash, Data.Num(), gco);
+		}
+		delete gco;
+		if (Loaded) {
+			return find(Hash, Data.Num(), Info);
+		}
+	}
+	return false;
+}
+
+void FMiVRyDatabaseCache::add(uint64 Hash, int64 Size, IGestureRecognition* gro)
+{
+	if (gro == nullptr) {
+		return;
+	}
+	Entry CacheEntry;
+	CacheEntry.Size = Size;
+	FMiVRyDatabaseInfo& Info = CacheEntry.Info;
+	Info.Type = GestureRecognition_DatabaseType::GestureRecognition;
+	TArray<FString>& GestureNames = Info.Parts.AddDefaulted_GetRef().GestureNames;
+	const int NumGestures = gro->numberOfGestures();
+	GestureNames.SetNum(NumGestures);
+	for (int32 i = 0; i < NumGestures; i++) {
+		GestureNames[i] = gro->getGestureName(i);
+	}
+	add(Hash, MoveTemp(CacheEntry));
+}
+
+void FMiVRyDatabaseCache::add(uint64 Hash, int64 Size, IGestureCombinations* gco)
+{
+	if (gco == nullptr) {
+		return;
+	}
+	Entry CacheEntry;
+	CacheEntry.Size = Size;
+	FMiVRyDatabaseInfo& Info = CacheEntry.Info;
+	Info.Type = GestureRecognition_DatabaseType::GestureCombinations;
+	const int NumParts = gco->numberOfParts();
+	Info.Parts.SetNum(FMath::Max(NumParts, 0));
+	for (int32 part = 0; part < NumParts; part++) {
+		TArray<FString>& GestureNames = Info.Parts[part].GestureNames;
+		const int NumGestures = gco->numberOfGestures(part);
+		GestureNames.SetNum(FMath::Max(NumGestures, 0));
+		for (int32 i = 0; i < NumGestures; i++) {
+			GestureNames[i] = gco->getGestureName(part, i);
+		}
+	}
+	const int NumCombinations = gco->numberOfGestureCombinations();
+	Info.GestureCombinationNames.SetNum(FMath::Max(NumCombinations, 0));
+	for (int32 i = 0; i < NumCombinations; i++) {
+		Info.GestureCombinationNames[i] = gco->getGestureCombinationName(i);
+	}
+	add(Hash, MoveTemp(CacheEntry));
+}
+
+void FMiVRyDatabaseCache::add(uint64 Hash, Entry&& CacheEntry)
+{
+	FScopeLock Lock(&Mutex);
+	if (Entries.Num() >= MaxEntries && !Entries.Contains(Hash)) {
+		// Evict the least recently used entry (eg. an outdated version of a re-saved database).
+		uint64 OldestHash = 0;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<uint64, Entry>& Pair : Entries) {
+			if (Pair.Value.LastUsed < OldestUse) {
+				OldestUse = Pair.Value.LastUsed;
+				OldestHash = Pair.Key;
+			}
+		}
+		Entries.Remove(OldestHash);
+	}
+	CacheEntry.LastUsed = ++UseCounter;
+	Entries.Add(Hash, MoveTemp(CacheEntry));
+}
+
+void FMiVRyDatabaseCache::clear()
+{
+	FScopeLock Lock(&Mutex);
+	Entries.Empty();
+}
@@ -0,0 +1,96 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MiVRyUtil.h"
+
+class IGestureRecognition;
+class IGestureCombinations;
+
+/**
+* Process-wide cache of gesture database information, keyed by a hash of the database contents.
+* Loading a gesture database fully parses the neural network and all recorded samples,
+* so this cache allows callers which load the same database repeatedly (behavior tree nodes,
+* MiVRy actors) to skip the redundant parsing steps.
+* At most MaxEntries databases are kept; the least recently used entries are evicted first.
+* All functions are thread-safe.
+*/
+class FMiVRyDatabaseCache
+{
+public:
+	/**
+	* Calculate the content hash of a gesture database.
+	* @param Data The gesture database contents.
+	* @param Size The number of bytes in Data.
+	* @return The hash of the database contents.
+	*/
+	static uint64 hash(const uint8* Data, int64 Size);
+
+	/**
+	* Look up a previously cached gesture database.
+	* @param Hash The content hash of the database (see hash()).
+	* @param Size The number of bytes in the database.
+	* @param Info [OUT] The cached database information.
+	* @return True if the database was found in the cache, false otherwise.
+	*/
+	static bool find(uint64 Hash, int64 Size, FMiVRyDatabaseInfo& Info);
+
+	/**
+	* Get the information about a gesture database, parsing it only if it was not cached yet.
+	* @param Data The gesture database contents.
+	* @param Info [OUT] The database information.
+	* @return True on success, false if the data could not be loaded as a gesture database.
+	*/
+	static bool get(const TArray<uint8>& Data, FMiVRyDatabaseInfo& Info);
+
+	/**
+	* Add the information of an already loaded gesture recognition object to the cache.
+	* @param Hash The content hash of the database from which the object was loaded.
+	* @param Size The number of bytes in the database.
+	* @param gro The loaded gesture recognition object.
+	*/
+	static void add(uint64 Hash, int64 Size, IGestureRecognition* gro);
+
+	/**
+	* Add the information of an already loaded gesture combinations object to the cache.
+	* @param Hash The content hash of the database from which the object was loaded.
+	* @param Size The number of bytes in the database.
+	* @param gco The loaded gesture combinations object.
+	*/
+	static void add(uint64 Hash, int64 Size, IGestureCombinations* gco);
+
+	/**
+	* Remove all entries from the cache.
+	*/
+	static void clear();
+
+private:
+	struct Entry
+	{
+		int64 Size = 0; //!< Size of the database in bytes (to guard against hash collisions).
+		FMiVRyDatabaseInfo Info; //!< The cached database information.
+		uint64 LastUsed = 0; //!< Value of UseCounter when the entry was last added or found.
+	};
+	static constexpr int32 MaxEntries = 32; //!< Maximum number of cached databases.
+	static void add(uint64 Hash, Entry&& CacheEntry);
+	static FCriticalSection Mutex; //!< Guards Entries.
+	static TMap<uint64, Entry> Entries; //!< Cached database information by content hash.
+	static uint64 UseCounter; //!< Incremented whenever an entry is added or found (for LRU eviction).
+};
@@ -0,0 +1,111 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MiVRyGestureDatabase.h"
+#include "MiVRy.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+const FName UMiVRyGestureDatabase::GestureNamesTag(TEXT("GestureNames"));
+
+void UMiVRyGestureDatabase::importFromBuffer(const TArray<uint8>& Buffer, GestureRecognition_Result& Result)
+{
+	TArray<uint8> Decompressed;
+	const TArray<uint8>* Database = &Buffer;
+	if (UMiVRyUtil::isCompressedDatabase(Buffer.GetData(), Buffer.Num())) {
+		if (!UMiVRyUtil::decompressDatabase(Buffer.GetData(), Buffer.Num(), Decompressed)) {
+			Result = GestureRecognition_Result::Error;
+			return;
+		}
+		Database = &Decompressed;
+	}
+	FMiVRyDatabaseInfo Info;
+	UMiVRyUtil::peekDatabase(*Database, Result, Info);
+	if (Result != GestureRecognition_Result::Then) {
+		return;
+	}
+	this->Modify();
+	this->Data = (Database == &Decompressed) ? MoveTemp(Decompressed) : Buffer;
+	this->Type = Info.Type;
+	this->GestureNames = Info.identifiableGestureNames();
+}
+
+bool UMiVRyGestureDatabase::getGestureNames(const FAssetData& AssetData, TArray<FString>& Names)
+{
+	FString NameList;
+	if (!AssetData.GetTagValue(GestureNamesTag, NameList)) {
+		return false;
+	}
+	Names.Empty();
+	NameList.ParseIntoArray(Names, TEXT("\n"), false);
+	return true;
+}
+
+void UMiVRyGestureDatabase::getGestureNames(const UMiVRyGestureDatabase* Database, TArray<FString>& Names)
+{
+	if (Database == nullptr) {
+		Names.Empty();
+		return;
+	}
+	if (Database->GetOutermost()->IsDirty()) {
+		Names = Database->GestureNames; // re-imported since the tags were gathered
+		return;
+	}
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
+	const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(Database));
+#else
+	const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(FName(*Database->GetPathName()));
+#endif
+	if (!getGestureNames(AssetData, Names)) {
+		Names = Database->GestureNames; // not registered (yet), eg. a newly created asset
+	}
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4
+void UMiVRyGestureDatabase::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
+{
+	Super::GetAssetRegistryTags(Context);
+	Context.AddTag(FAssetRegistryTag(GestureNamesTag, FString::Join(this->GestureNames, TEXT("\n")), FAssetRegistryTag::TT_Hidden));
+}
+#else
+void UMiVRyGestureDatabase::GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const
+{
+	Super::GetAssetRegistryTags(OutTags);
+	OutTags.Add(FAssetRegistryTag(GestureNamesTag, FString::Join(this->GestureNames, TEXT("\n")), FAssetRegistryTag::TT_Hidden));
+}
+#endif
+
+#if WITH_EDITOR
+void UMiVRyGestureDatabase::importFromSourceFile()
+{
+	TArray<uint8> Buffer;
+	GestureRecognition_Result Result;
+	UMiVRyUtil::readFileToBuffer(this->SourceFile.FilePath, Result, Buffer);
+	if (Result != GestureRecognition_Result::Then) {
+		UE_LOG(LogMiVRy, Error, TEXT("[MiVRyGestureDatabase] Could not read gesture database file '%s'."), *this->SourceFile.FilePath);
+		return;
+	}
+	this->importFromBuffer(Buffer, Result);
+	if (Result != GestureRecognition_Result::Then) {
+		UE_LOG(LogMiVRy, Error, TEXT("[MiVRyGestureDatabase] '%s' is not a valid gesture database file."), *this->SourceFile.FilePath);
+		return;
+	}
+	UE_LOG(LogMiVRy, Display, TEXT("[MiVRyGestureDatabase] Imported %i gestures from '%s'."), this->GestureNames.Num(), *this->SourceFile.FilePath);
+}
+#endif
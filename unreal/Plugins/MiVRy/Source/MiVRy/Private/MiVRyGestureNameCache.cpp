@@ -0,0 +1,164 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MiVRyGestureNameCache.h"
+#include "MiVRyUtil.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Modules/ModuleManager.h"
+#endif
+
+FCriticalSection FMiVRyGestureNameCache::Mutex;
+TMap<FString, FMiVRyGestureNameCache::Entry> FMiVRyGestureNameCache::Entries;
+TMap<FString, FDelegateHandle> FMiVRyGestureNameCache::WatchedDirectories;
+
+int FMiVRyGestureNameCache::get(const FString& Path, TArray<FString>& Names)
+{
+	FScopeLock Lock(&Mutex);
+	Entry* Found = Entries.Find(Path);
+	if (Found == nullptr) {
+		Found = &Entries.Add(Path);
+	}
+	// Only (re-)read new entries, modified files, and files that were not found (throttled).
+	const bool NotFoundRetry = (Found->Error == -3 && FPlatformTime::Seconds() >= Found->RetryTime);
+	if (!Found->Loading && (Found->Error == -15 || Found->Stale || NotFoundRetry)) {
+		Found->Loading = true;
+		Found->Stale = false;
+		const FString LoadPath = Path;
+		Async(EAsyncExecution::ThreadPool, [LoadPath]() {
+			load(LoadPath);
+		});
+	}
+	if (Found->Error == 0) {
+		Names = Found->Names;
+	}
+	return Found->Error;
+}
+
+void FMiVRyGestureNameCache::load(const FString& Path)
+{
+	GestureRecognition_Result find_result;
+	FString FullPath;
+	UMiVRyUtil::findFile(Path, find_result, FullPath);
+	FDateTime TimeStamp;
+	if (find_result == GestureRecognition_Result::Then) {
+		FullPath = FPaths::ConvertRelativePathToFull(FullPath);
+		FPaths::NormalizeFilename(FullPath);
+		TimeStamp = IFileManager::Get().GetTimeStamp(*FullPath);
+	} else {
+		FullPath.Empty();
+	}
+	{
+		FScopeLock Lock(&Mutex);
+		Entry* Found = Entries.Find(Path);
+		if (Found != nullptr && Found->Error == 0 && Found->FullPath == FullPath && Found->TimeStamp == TimeStamp) {
+			Found->Loading = false; // unchanged
+			return;
+		}
+	}
+	TArray<FString> Names;
+	int Error = -3;
+	if (!FullPath.IsEmpty()) {
+		FMiVRyDatabaseInfo Info;
+		GestureRecognition_Result peek_result;
+		UMiVRyUtil::peekDatabaseFile(FullPath, peek_result, Info);
+		if (peek_result == GestureRecognition_Result::Then) {
+			Names = Info.identifiableGestureNames();
+			Error = 0;
+		} else {
+			Error = -1;
+		}
+	}
+	{
+		FScopeLock Lock(&Mutex);
+		Entry* Found = Entries.Find(Path);
+		if (Found == nullptr) {
+			return; // cleared in the meantime
+		}
+		Found->FullPath = FullPath;
+		Found->TimeStamp = TimeStamp;
+		Found->Names = MoveTemp(Names);
+		Found->Error = Error;
+		Found->RetryTime = FPlatformTime::Seconds() + NotFoundRetryInterval;
+		Found->Loading = false;
+	}
+	if (!FullPath.IsEmpty()) {
+		AsyncTask(ENamedThreads::GameThread, [FullPath]() {
+			watch(FullPath);
+		});
+	}
+}
+
+void FMiVRyGestureNameCache::watch(const FString& FullPath)
+{
+#if WITH_EDITOR
+	const FString Directory = FPaths::GetPath(FullPath);
+	{
+		FScopeLock Lock(&Mutex);
+		if (WatchedDirectories.Contains(Directory)) {
+			return;
+		}
+	}
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr) {
+		return;
+	}
+	FDelegateHandle Handle;
+	DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+		Directory,
+		IDirectoryWatcher::FDirectoryChanged::CreateLambda([](const TArray<FFileChangeData>& Changes) {
+			FScopeLock Lock(&Mutex);
+			for (const FFileChangeData& Change : Changes) {
+				FString ChangedPath = FPaths::ConvertRelativePathToFull(Change.Filename);
+				FPaths::NormalizeFilename(ChangedPath);
+				for (TPair<FString, Entry>& Pair : Entries) {
+					if (Pair.Value.FullPath == ChangedPath) {
+						Pair.Value.Stale = true;
+					}
+				}
+			}
+		}),
+		Handle
+	);
+	FScopeLock Lock(&Mutex);
+	WatchedDirectories.Add(Directory, Handle);
+#endif
+}
+
+void FMiVRyGestureNameCache::clear()
+{
+	FScopeLock Lock(&Mutex);
+	Entries.Empty();
+#if WITH_EDITOR
+	FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule ? DirectoryWatcherModule->Get() : nullptr;
+	if (DirectoryWatcher != nullptr) {
+		for (const TPair<FString, FDelegateHandle>& Pair : WatchedDirectories) {
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Pair.Key, Pair.Value);
+		}
+	}
+#endif
+	WatchedDirectories.Empty();
+}
@@ -0,0 +1,68 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Process-wide cache of the gesture names of gesture database files, keyed by file path.
+* Behavior tree nodes use this to describe their gesture mapping in the editor:
+* files are read and parsed on a background thread, so that requesting the names
+* never touches the disk or the gesture database parser on the calling thread.
+* In the editor, database files are watched and re-read when they are modified.
+* Files which could not be parsed are only re-read when modified, and files which were not found
+* are looked for again at most every NotFoundRetryInterval seconds.
+* All functions are thread-safe.
+*/
+class FMiVRyGestureNameCache
+{
+public:
+	/**
+	* Get the names of the identifiable gestures (or gesture combinations) of a gesture database file.
+	* If the names are not cached yet, loading them is started in the background.
+	* While a modified file is re-read, the previous names are returned.
+	* @param Path The path to the gesture database file.
+	* @param Names [OUT] The gesture names (if available).
+	* @return Zero on success, -15 if the file is still being loaded, or another negative error code.
+	*/
+	static int get(const FString& Path, TArray<FString>& Names);
+
+	/**
+	* Remove all entries from the cache and stop watching files.
+	*/
+	static void clear();
+
+private:
+	struct Entry
+	{
+		FString FullPath; //!< Absolute path of the file that was found (empty if not found).
+		FDateTime TimeStamp; //!< Modification time of the file when it was read.
+		TArray<FString> Names; //!< The gesture names (if loaded successfully).
+		int Error = -15; //!< Zero if Names are valid, -15 while loading for the first time, or an error code.
+		bool Loading = false; //!< Whether the file is currently being read in the background.
+		bool Stale = false; //!< Whether the file was modified since it was read.
+		double RetryTime = 0; //!< When to look for the file again if it was not found (FPlatformTime::Seconds).
+	};
+	static constexpr double NotFoundRetryInterval = 5.0; //!< Seconds before looking for a file again that was not found.
+	static void load(const FString& Path); //!< Read and parse a gesture database file (any thread).
+	static void watch(const FString& FullPath); //!< Mark the entry as stale when the file changes (game thread).
+	static FCriticalSection Mutex; //!< Guards Entries and WatchedDirectories.
+	static TMap<FString, Entry> Entries; //!< Cached gesture names by file path (as requested).
+	static TMap<FString, FDelegateHandle> WatchedDirectories; //!< Directory watcher registrations by directory.
+};
@@ -18,9 +18,142 @@
 
 #include "MiVRyUtil.h"
 #include "GestureRecognition.h"
+#include "MiVRyDatabaseCache.h"
 #include "Core.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Runtime/Launch/Resources/Version.h" // for ENGINE_MAJOR_VERSION / ENGINE_MINOR_VERSION
 #include <fstream>
 
+/*
+* Layout of compressed gesture database files:
+* [magic (8 bytes)] [codec (uint32)] [chunk size (uint32)] [uncompressed size (int64)] [number of chunks (uint32)]
+* [compressed size of each chunk (uint32 each)] [compressed chunk data...]
+* Every chunk can be decompressed independently, so files can be decompressed while they are being read.
+*/
+static const uint8 CompressedDatabaseMagic[8] = { 'M', 'i', 'V', 'R', 'y', 'Z', 0, 1 };
+#define MIVRY_COMPRESSION_CODEC_ZLIB   1 //!< Chunks compressed with zlib.
+#define MIVRY_COMPRESSION_CODEC_OODLE  2 //!< Chunks compressed with Oodle.
+#define MIVRY_COMPRESSION_CHUNKSIZE    (256 * 1024) //!< Number of uncompressed bytes per chunk.
+#define MIVRY_COMPRESSION_HEADERSIZE   28 //!< Number of bytes in the header (before the chunk size table).
+#define MIVRY_COMPRESSION_MINCHUNKSIZE (4 * 1024) //!< Smallest accepted number of uncompressed bytes per chunk when reading.
+#define MIVRY_COMPRESSION_MAXCHUNKSIZE (16 * 1024 * 1024) //!< Largest accepted number of uncompressed bytes per chunk when reading.
+#if ENGINE_MAJOR_VERSION >= 5
+#define MIVRY_COMPRESSION_CODEC_DEFAULT MIVRY_COMPRESSION_CODEC_OODLE
+#else
+#define MIVRY_COMPRESSION_CODEC_DEFAULT MIVRY_COMPRESSION_CODEC_ZLIB
+#endif
+
+struct FMiVRyCompressedDatabaseHeader
+{
+	uint32 Codec = 0;
+	uint32 ChunkSize = 0;
+	int64 UncompressedSize = 0;
+	uint32 NumChunks = 0;
+};
+
+static FName compressionCodecName(uint32 codec)
+{
+	switch (codec) {
+	case MIVRY_COMPRESSION_CODEC_ZLIB:
+		return NAME_Zlib;
+#if ENGINE_MAJOR_VERSION >= 5
+	case MIVRY_COMPRESSION_CODEC_OODLE:
+		return NAME_Oodle;
+#endif
+	}
+	return NAME_None;
+}
+
+static bool readCompressedDatabaseHeader(FArchive& Ar, FMiVRyCompressedDatabaseHeader& Header)
+{
+	if (Ar.TotalSize() - Ar.Tell() < MIVRY_COMPRESSION_HEADERSIZE) {
+		return false;
+	}
+	uint8 magic[sizeof(CompressedDatabaseMagic)];
+	Ar.Serialize(magic, sizeof(magic));
+	if (Ar.IsError() || FMemory::Memcmp(magic, CompressedDatabaseMagic, sizeof(magic)) != 0) {
+		return false;
+	}
+	Ar << Header.Codec;
+	Ar << Header.ChunkSize;
+	Ar << Header.UncompressedSize;
+	Ar << Header.NumChunks;
+	if (Ar.IsError() || compressionCodecName(Header.Codec) == NAME_None) {
+		return false;
+	}
+	if (Header.ChunkSize < MIVRY_COMPRESSION_MINCHUNKSIZE || Header.ChunkSize > MIVRY_COMPRESSION_MAXCHUNKSIZE || Header.UncompressedSize < 0 || Header.UncompressedSize > MAX_int32) {
+		return false;
+	}
+	if ((int64)Header.NumChunks != (Header.UncompressedSize + Header.ChunkSize - 1) / Header.ChunkSize) {
+		return false;
+	}
+	// The chunk size table must fit into the rest of the file.
+	return (int64)Header.NumChunks * (int64)sizeof(uint32) <= Ar.TotalSize() - Ar.Tell();
+}
+
+static bool decompressDatabaseArchive(FArchive& Ar, TArray<uint8>& Data)
+{
+	FMiVRyCompressedDatabaseHeader Header;
+	if (!readCompressedDatabaseHeader(Ar, Header)) {
+		return false;
+	}
+	const FName Codec = compressionCodecName(Header.Codec);
+	TArray<uint32> ChunkSizes;
+	ChunkSizes.SetNumUninitialized(Header.NumChunks);
+	for (uint32& ChunkSize : ChunkSizes) {
+		Ar << ChunkSize;
+	}
+	if (Ar.IsError()) {
+		return false;
+	}
+	Data.SetNumUninitialized((int32)Header.UncompressedSize);
+	TArray<uint8> Chunk;
+	int64 Offset = 0;
+	for (const uint32 ChunkSize : ChunkSizes) {
+		if ((int64)ChunkSize > Ar.TotalSize() - Ar.Tell()) {
+			return false;
+		}
+		Chunk.SetNumUninitialized((int32)ChunkSize);
+		Ar.Serialize(Chunk.GetData(), Chunk.Num());
+		if (Ar.IsError()) {
+			return false;
+		}
+		const int32 UncompressedChunkSize = (int32)FMath::Min<int64>(Header.ChunkSize, Header.UncompressedSize - Offset);
+		if (!FCompression::UncompressMemory(Codec, Data.GetData() + Offset, UncompressedChunkSize, Chunk.GetData(), Chunk.Num())) {
+			return false;
+		}
+		Offset += UncompressedChunkSize;
+	}
+	return true;
+}
+
+/*
+* Read a gesture database file into memory, decompressing it on-the-fly if necessary.
+*/
+static bool loadDatabaseFile(const FString& path, TArray<uint8>& data)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*path));
+	if (!Reader) {
+		return false;
+	}
+	FMiVRyCompressedDatabaseHeader Header;
+	const bool IsCompressed = readCompressedDatabaseHeader(*Reader, Header);
+	Reader->Seek(0);
+	if (IsCompressed) {
+		return decompressDatabaseArchive(*Reader, data) && Reader->Close();
+	}
+	const int64 TotalSize = Reader->TotalSize();
+	if (TotalSize > MAX_int32) {
+		return false;
+	}
+	data.SetNumUninitialized((int32)TotalSize);
+	Reader->Serialize(data.GetData(), data.Num());
+	return Reader->Close();
+}
+
 FString UMiVRyUtil::versionString()
 {
 	return FString(IGestureRecognition::getVersionString());
@@ -217,7 +350,7 @@ void UMiVRyUtil::findFile(const FString& Path, GestureRecognition_Result& Result
 
 void UMiVRyUtil::readFileToBuffer(const FString& path, GestureRecognition_Result& result, TArray<uint8>& data)
 {
-	if (FFileHelper::LoadFileToArray(data, *path)) {
+	if (loadDatabaseFile(path, data)) {
 		result = GestureRecognition_Result::Then;
 		return;
 	}
@@ -226,18 +359,125 @@ void UMiVRyUtil::readFileToBuffer(const FString& path, GestureRecognition_Result
 		return;
 	}
 	FString relpath = FPaths::Combine(FPaths::ProjectDir(), path);
-	if (FFileHelper::LoadFileToArray(data, *relpath)) {
+	if (loadDatabaseFile(relpath, data)) {
 		result = GestureRecognition_Result::Then;
 		return;
 	}
 	FString abspath = FPaths::ConvertRelativePathToFull(relpath);
-	if (FFileHelper::LoadFileToArray(data, *abspath)) {
+	if (loadDatabaseFile(abspath, data)) {
 		result = GestureRecognition_Result::Then;
 		return;
 	}
 	result = GestureRecognition_Result::Error;
 }
 
+void UMiVRyUtil::peekDatabase(const TArray<uint8>& data, GestureRecognition_Result& result, FMiVRyDatabaseInfo& info)
+{
+	const TArray<uint8>* database = &data;
+	TArray<uint8> decompressed;
+	if (isCompressedDatabase(data.GetData(), data.Num())) {
+		if (!decompressDatabase(data.GetData(), data.Num(), decompressed)) {
+			result = GestureRecognition_Result::Error;
+			return;
+		}
+		database = &decompressed;
+	}
+	result = FMiVRyDatabaseCache::get(*database, info) ? GestureRecognition_Result::Then : GestureRecognition_Result::Error;
+}
+
+void UMiVRyUtil::peekDatabaseFile(const FString& path, GestureRecognition_Result& result, FMiVRyDatabaseInfo& info)
+{
+	TArray<uint8> data;
+	readFileToBuffer(path, result, data);
+	if (result != GestureRecognition_Result::Then) {
+		return;
+	}
+	result = FMiVRyDatabaseCache::get(data, info) ? GestureRecognition_Result::Then : GestureRecognition_Result::Error;
+}
+
+void UMiVRyUtil::compressDatabase(const TArray<uint8>& data, GestureRecognition_Result& result, TArray<uint8>& compressed_data)
+{
+	compressed_data.Reset();
+	const uint32 CodecId = MIVRY_COMPRESSION_CODEC_DEFAULT;
+	const FName Codec = compressionCodecName(CodecId);
+	TArray<uint32> ChunkSizes;
+	TArray<uint8> ChunkData;
+	TArray<uint8> Chunk;
+	for (int32 Offset = 0; Offset < data.Num(); Offset += MIVRY_COMPRESSION_CHUNKSIZE) {
+		const int32 UncompressedChunkSize = FMath::Min(MIVRY_COMPRESSION_CHUNKSIZE, data.Num() - Offset);
+		int32 ChunkSize = FCompression::CompressMemoryBound(Codec, UncompressedChunkSize);
+		Chunk.SetNumUninitialized(ChunkSize);
+		if (!FCompression::CompressMemory(Codec, Chunk.GetData(), ChunkSize, data.GetData() + Offset, UncompressedChunkSize)) {
+			result = GestureRecognition_Result::Error;
+			return;
+		}
+		ChunkSizes.Add((uint32)ChunkSize);
+		ChunkData.Append(Chunk.GetData(), ChunkSize);
+	}
+	FMiVRyCompressedDatabaseHeader Header;
+	Header.Codec = CodecId;
+	Header.ChunkSize = MIVRY_COMPRESSION_CHUNKSIZE;
+	Header.UncompressedSize = data.Num();
+	Header.NumChunks = (uint32)ChunkSizes.Num();
+	FMemoryWriter Writer(compressed_data);
+	Writer.Serialize((void*)CompressedDatabaseMagic, sizeof(CompressedDatabaseMagic));
+	Writer << Header.Codec;
+	Writer << Header.ChunkSize;
+	Writer << Header.UncompressedSize;
+	Writer << Header.NumChunks;
+	for (uint32& ChunkSize : ChunkSizes) {
+		Writer << ChunkSize;
+	}
+	Writer.Serialize(ChunkData.GetData(), ChunkData.Num());
+	result = GestureRecognition_Result::Then;
+}
+
+void UMiVRyUtil::compressDatabaseFile(const FString& source_path, const FString& target_path, GestureRecognition_Result& result)
+{
+	TArray<uint8> data;
+	readFileToBuffer(source_path, result, data);
+	if (result != GestureRecognition_Result::Then) {
+		return;
+	}
+	TArray<uint8> compressed_data;
+	compressDatabase(data, result, compressed_data);
+	if (result != GestureRecognition_Result::Then) {
+		return;
+	}
+	FString path = target_path;
+	if (FPaths::IsRelative(path)) {
+		path = FPaths::Combine(FPaths::ProjectDir(), path);
+	}
+	result = FFileHelper::SaveArrayToFile(compressed_data, *path) ? GestureRecognition_Result::Then : GestureRecognition_Result::Error;
+}
+
+bool UMiVRyUtil::isCompressedDatabase(const uint8* data, int64 size)
+{
+	if (data == nullptr || size < MIVRY_COMPRESSION_HEADERSIZE) {
+		return false;
+	}
+	return FMemory::Memcmp(data, CompressedDatabaseMagic, sizeof(CompressedDatabaseMagic)) == 0;
+}
+
+bool UMiVRyUtil::isCompressedDatabaseFile(const FString& path)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*path));
+	if (!Reader) {
+		return false;
+	}
+	FMiVRyCompressedDatabaseHeader Header;
+	return readCompressedDatabaseHeader(*Reader, Header);
+}
+
+bool UMiVRyUtil::decompressDatabase(const uint8* data, int64 size, TArray<uint8>& decompressed_data)
+{
+	if (!isCompressedDatabase(data, size)) {
+		return false;
+	}
+	FBufferReader Reader((void*)data, size, false);
+	return decompressDatabaseArchive(Reader, decompressed_data);
+}
+
 const FQuat RotateYp55(0, 0.4617486f,  0, 0.8870108f); // Controller rotation: OpenXR -> OculusVR
 const FQuat RotateYm55(0, -0.4617486f, 0, 0.8870108f); // Controller rotation: OculusVR -> OpenXR
 const FQuat RotateYp25(0, 0.2164396f,  0, 0.976296f ); // Controller rotation: SteamVR -> OculusVR
@@ -247,313 +487,213 @@ const FQuat RotateYm20(0, -0.258819f,  0, 0.9659258f); // Controller rotation: S
 const FQuat RotateXZY( 0.5f,  0.5f,       0.5f,       0.5f);
 const FQuat RotateXYZ(-0.5f, -0.5f,      -0.5f,       0.5f);
 
-void UMiVRyUtil::convertInput(const FVector& location, const FQuat& rotation_in, GestureRecognition_DeviceType device_type, GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, double p[3], double q[4])
+/**
+* Controller rotation between the UE VR plugin and the VR plugin of a MiVRy coordinate system.
+* @param to_unreal Whether to convert from the MiVRy coordinate system to the UE VR plugin (instead of the other way around).
+*/
+static FQuat controllerRotation(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, bool to_unreal)
 {
-	FQuat rotation = rotation_in;
-    if (vr_plugin == GestureRecognition_VRPlugin::OculusVR) {
-        switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-            p[0] = location.X;
-            p[1] = location.Y;
-            p[2] = location.Z;
-			if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OpenXR) {
-					rotation = rotation * RotateYm55; // Unreal_OculusVR -> Unreal_OpenXR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_SteamVR) {
-					rotation = rotation * RotateYm25; // Unreal_OculusVR -> Unreal_SteamVR
-				}
-			}
-			q[0] = rotation.X;
-			q[1] = rotation.Y;
-			q[2] = rotation.Z;
-			q[3] = rotation.W;
-            return;
-        }
-        // else: one of the Unity coordinate systems
-		rotation = RotateXYZ * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-			rotation = rotation * RotateXZY;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateYm55 * RotateXZY; // Unreal_OculusVR -> Unity_OpenXR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-				rotation = rotation * RotateYm25 * RotateXZY; // Unreal_OculusVR -> Unity_SteamVR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-				rotation = rotation * RotateXZY; // Unreal_OculusVR -> Unreal_OculusVR
-                break;
-            }
-            break;
-        }
-        p[0] = location.Y * 0.01; // Unity.X = right = Unreal.Y
-        p[1] = location.Z * 0.01; // Unity.Y = up    = Unreal.Z
-        p[2] = location.X * 0.01; // Unity.Z = front = Unreal.X
-        q[0] = rotation.X;
-        q[1] = rotation.Y;
-        q[2] = rotation.Z;
-        q[3] = rotation.W;
-        return;
-    } else
-	if (vr_plugin == GestureRecognition_VRPlugin::SteamVR) {
-		switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-            p[0] = location.X;
-            p[1] = location.Y;
-            p[2] = location.Z;
-			if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OpenXR) {
-					rotation = rotation * RotateYm20; // Unreal_SteamVR -> Unreal_OpenXR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OculusVR) {
-					rotation = rotation * RotateYp25; // Unreal_SteamVR -> Unreal_OculusVR
-				}
-			}
-			q[0] = rotation.X;
-			q[1] = rotation.Y;
-			q[2] = rotation.Z;
-			q[3] = rotation.W;
-            return;
-        }
-        // else: one of the Unity coordinate systems
-		rotation = RotateXYZ * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-			rotation = rotation * RotateXZY;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateYm20 * RotateXZY; // Unreal_SteamVR -> Unity_OpenXR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-				rotation = rotation * RotateXZY; // Unreal_SteamVR -> Unity_SteamVR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-				rotation = rotation * RotateYp25 * RotateXZY; // Unreal_SteamVR -> Unity_OculusVR
-                break;
-            }
-            break;
-        }
-        p[0] = location.Y * 0.01; // Unity.X = right = Unreal.Y
-        p[1] = location.Z * 0.01; // Unity.Y = up    = Unreal.Z
-        p[2] = location.X * 0.01; // Unity.Z = front = Unreal.X
-        q[0] = rotation.X;
-        q[1] = rotation.Y;
-        q[2] = rotation.Z;
-        q[3] = rotation.W;
-        return;
-	} else { // (vr_plugin == GestureRecognition_VRPlugin::Unreal_OpenXR)
-		switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-            p[0] = location.X;
-            p[1] = location.Y;
-            p[2] = location.Z;
-			if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_SteamVR) {
-					rotation = rotation * RotateYp20; // Unreal_OpenXR -> Unreal_SteamVR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OculusVR) {
-					rotation = rotation * RotateYp55; // Unreal_OpenXR -> Unreal_OculusVR
+	GestureRecognition_VRPlugin coord_sys_plugin;
+	switch (coord_sys) {
+	case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
+	case GestureRecognition_CoordinateSystem::Unity_SteamVR:
+		coord_sys_plugin = GestureRecognition_VRPlugin::SteamVR;
+		break;
+	case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
+	case GestureRecognition_CoordinateSystem::Unity_OculusVR:
+		coord_sys_plugin = GestureRecognition_VRPlugin::OculusVR;
+		break;
+	default:
+		coord_sys_plugin = GestureRecognition_VRPlugin::OpenXR;
+	}
+	if (vr_plugin == GestureRecognition_VRPlugin::OculusVR) {
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::OpenXR) {
+			return to_unreal ? RotateYp55 : RotateYm55;
+		}
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::SteamVR) {
+			return to_unreal ? RotateYp25 : RotateYm25;
+		}
+	} else if (vr_plugin == GestureRecognition_VRPlugin::SteamVR) {
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::OpenXR) {
+			return to_unreal ? RotateYp20 : RotateYm20;
+		}
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::OculusVR) {
+			return to_unreal ? RotateYm25 : RotateYp25;
+		}
+	} else { // vr_plugin == GestureRecognition_VRPlugin::OpenXR
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::SteamVR) {
+			return to_unreal ? RotateYm20 : RotateYp20;
+		}
+		if (coord_sys_plugin == GestureRecognition_VRPlugin::OculusVR) {
+			return to_unreal ? RotateYm55 : RotateYp55;
+		}
+	}
+	return FQuat::Identity;
+}
+
+FMiVRyCoordinateConversion::FMiVRyCoordinateConversion(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, GestureRecognition_DeviceType device_type)
+{
+	switch (coord_sys) {
+	case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
+	case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
+	case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
+		if (device_type == GestureRecognition_DeviceType::Controller) {
+			InputPost = controllerRotation(vr_plugin, coord_sys, false);
+			OutputPost = controllerRotation(vr_plugin, coord_sys, true);
+		}
+		return;
+	}
+	// else: one of the Unity coordinate systems
+	InputSwizzle[0] = 1; // Unity.X = right = Unreal.Y
+	InputSwizzle[1] = 2; // Unity.Y = up    = Unreal.Z
+	InputSwizzle[2] = 0; // Unity.Z = front = Unreal.X
+	InputScale = 0.01;
+	OutputSwizzle[0] = 2; // Unreal.X = front = Unity.Z
+	OutputSwizzle[1] = 0; // Unreal.Y = right = Unity.X
+	OutputSwizzle[2] = 1; // Unreal.Z = up    = Unity.Y
+	OutputScale = 100.0;
+	OutputNormalize = true;
+	InputPre = RotateXYZ;
+	OutputPre = RotateXZY;
+	switch (device_type) {
+	case GestureRecognition_DeviceType::Headset:
+		InputPost = RotateXZY;
+		OutputPost = RotateXYZ;
+		break;
+	case GestureRecognition_DeviceType::Controller:
+		InputPost = controllerRotation(vr_plugin, coord_sys, false) * RotateXZY;
+		OutputPost = RotateXYZ * controllerRotation(vr_plugin, coord_sys, true);
+		break;
+	}
+}
+
+const FMiVRyCoordinateConversion& FMiVRyCoordinateConversion::get(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, GestureRecognition_DeviceType device_type)
+{
+	static constexpr int32 NumPlugins = 3;
+	static constexpr int32 NumCoordSys = 6;
+	static constexpr int32 NumDeviceTypes = 3;
+	static const TArray<FMiVRyCoordinateConversion> conversions = []() {
+		TArray<FMiVRyCoordinateConversion> table;
+		table.Reserve(NumPlugins * NumCoordSys * NumDeviceTypes);
+		for (int32 plugin = 0; plugin < NumPlugins; plugin++) {
+			for (int32 cs = 0; cs < NumCoordSys; cs++) {
+				for (int32 device = 0; device < NumDeviceTypes; device++) {
+					table.Emplace((GestureRecognition_VRPlugin)plugin, (GestureRecognition_CoordinateSystem)cs, (GestureRecognition_DeviceType)device);
 				}
 			}
-			q[0] = rotation.X;
-			q[1] = rotation.Y;
-			q[2] = rotation.Z;
-			q[3] = rotation.W;
-            return;
-        }
-        // else: one of the Unity coordinate systems
-		rotation = RotateXYZ * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-			rotation = rotation * RotateXZY;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateXZY; // Unreal_OpenXR -> Unity_OpenXR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-				rotation = rotation * RotateYp20 * RotateXZY; // Unreal_OpenXR -> Unity_SteamVR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-				rotation = rotation * RotateYp55 * RotateXZY; // Unreal_OpenXR -> Unity_OculusVR
-                break;
-            }
-            break;
-        }
-        p[0] = location.Y * 0.01; // Unity.X = right = Unreal.Y
-        p[1] = location.Z * 0.01; // Unity.Y = up    = Unreal.Z
-        p[2] = location.X * 0.01; // Unity.Z = front = Unreal.X
-        q[0] = rotation.X;
-        q[1] = rotation.Y;
-        q[2] = rotation.Z;
-        q[3] = rotation.W;
-        return;
+		}
+		return table;
+	}();
+	const int32 plugin = ((int32)vr_plugin < NumPlugins) ? (int32)vr_plugin : (int32)GestureRecognition_VRPlugin::OpenXR;
+	const int32 cs = ((int32)coord_sys < NumCoordSys) ? (int32)coord_sys : (int32)GestureRecognition_CoordinateSystem::Unreal_OpenXR;
+	const int32 device = ((int32)device_type < NumDeviceTypes) ? (int32)device_type : (int32)GestureRecognition_DeviceType::None;
+	return conversions[(plugin * NumCoordSys + cs) * NumDeviceTypes + device];
+}
+
+void FMiVRyCoordinateConversion::convertInput(const FVector& location, const FQuat& rotation, double p[3], double q[4]) const
+{
+	p[0] = location[InputSwizzle[0]] * InputScale;
+	p[1] = location[InputSwizzle[1]] * InputScale;
+	p[2] = location[InputSwizzle[2]] * InputScale;
+	const FQuat r = InputPre * rotation * InputPost;
+	q[0] = r.X;
+	q[1] = r.Y;
+	q[2] = r.Z;
+	q[3] = r.W;
+}
+
+void FMiVRyCoordinateConversion::convertOutput(const double p[3], const double q[4], FVector& location, FQuat& rotation) const
+{
+	location.X = (float)(p[OutputSwizzle[0]] * OutputScale);
+	location.Y = (float)(p[OutputSwizzle[1]] * OutputScale);
+	location.Z = (float)(p[OutputSwizzle[2]] * OutputScale);
+	rotation.X = (float)q[0];
+	rotation.Y = (float)q[1];
+	rotation.Z = (float)q[2];
+	rotation.W = (float)q[3];
+	if (OutputNormalize) {
+		rotation.Normalize();
 	}
+	rotation = OutputPre * rotation * OutputPost;
 }
 
+void FMiVRyCoordinateConversion::convertInputArray(TArrayView<const FVector> locations, TArrayView<const FQuat> rotations, double* p, double* q) const
+{
+	check(locations.Num() == rotations.Num());
+	// Positions and rotations in separate loops, so that the position loop can be vectorized.
+	const int32 num = locations.Num();
+	const int32 sx = InputSwizzle[0];
+	const int32 sy = InputSwizzle[1];
+	const int32 sz = InputSwizzle[2];
+	const double scale = InputScale;
+	for (int32 i = 0; i < num; i++) {
+		const FVector& location = locations[i];
+		p[3 * i + 0] = location[sx] * scale;
+		p[3 * i + 1] = location[sy] * scale;
+		p[3 * i + 2] = location[sz] * scale;
+	}
+	for (int32 i = 0; i < num; i++) {
+		const FQuat r = InputPre * rotations[i] * InputPost;
+		q[4 * i + 0] = r.X;
+		q[4 * i + 1] = r.Y;
+		q[4 * i + 2] = r.Z;
+		q[4 * i + 3] = r.W;
+	}
+}
 
-void UMiVRyUtil::convertOutput(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, const double p[3], const double q[4], GestureRecognition_DeviceType device_type, FVector& location, FQuat& rotation)
+void FMiVRyCoordinateConversion::convertOutputArray(const double* p, const double* q, TArrayView<FVector> locations, TArrayView<FQuat> rotations) const
 {
-    if (vr_plugin == GestureRecognition_VRPlugin::OculusVR) {
-        switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-            location.X = (float)p[0];
-            location.Y = (float)p[1];
-            location.Z = (float)p[2];
-            rotation.X = (float)q[0];
-            rotation.Y = (float)q[1];
-            rotation.Z = (float)q[2];
-            rotation.W = (float)q[3];
-            if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OpenXR) {
-					rotation = rotation * RotateYp55; // Unreal_OpenXR -> Unreal_OculusVR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_SteamVR) {
-					rotation = rotation * RotateYp25; // Unreal_SteamVR -> Unreal_OculusVR
-				}
-            }
-            return;
-        }
-        // else: one of the Unity coordinate systems
-        location.X = 100.0f * (float)p[2]; // Unreal.X = front = Unity.Z
-        location.Y = 100.0f * (float)p[0]; // Unreal.Y = right = Unity.X
-        location.Z = 100.0f * (float)p[1]; // Unreal.Z = up    = Unity.Y
-        rotation.X = (float)q[0]; // in Unity coordinates
-        rotation.Y = (float)q[1];
-        rotation.Z = (float)q[2];
-        rotation.W = (float)q[3];
-        rotation.Normalize();
-        rotation = RotateXZY * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-            rotation = rotation * RotateXYZ;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateXYZ * RotateYp55; // Unity_OpenXR -> Unreal_OculusVR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-                rotation = rotation * RotateXYZ * RotateYp25; // Unity_SteamVR -> Unreal_OculusVR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-                rotation = rotation * RotateXYZ; // Unity_OculusVR -> Unreal_OculusVR
-                break;
-            }
-            break;
-        }
-        return;
-    } else
-	if (vr_plugin == GestureRecognition_VRPlugin::SteamVR) {
-		switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-            location.X = (float)p[0];
-            location.Y = (float)p[1];
-            location.Z = (float)p[2];
-            rotation.X = (float)q[0];
-            rotation.Y = (float)q[1];
-            rotation.Z = (float)q[2];
-            rotation.W = (float)q[3];
-            if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OpenXR) {
-					rotation = rotation * RotateYp20; // Unreal_OpenXR -> Unreal_SteamVR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OculusVR) {
-					rotation = rotation * RotateYm25; // Unreal_OculusVR -> Unreal_SteamVR
-				}
-            }
-            return;
-        }
-        // else: one of the Unity coordinate systems
-        location.X = 100.0f * (float)p[2]; // Unreal.X = front = Unity.Z
-        location.Y = 100.0f * (float)p[0]; // Unreal.Y = right = Unity.X
-        location.Z = 100.0f * (float)p[1]; // Unreal.Z = up    = Unity.Y
-        rotation.X = (float)q[0]; // in Unity coordinates
-        rotation.Y = (float)q[1];
-        rotation.Z = (float)q[2];
-        rotation.W = (float)q[3];
-        rotation.Normalize();
-        rotation = RotateXZY * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-            rotation = rotation * RotateXYZ;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateXYZ * RotateYp20; // Unity_OpenXR -> Unreal_SteamVR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-                rotation = rotation * RotateXYZ; // Unity_SteamVR -> Unreal_SteamVR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-                rotation = rotation * RotateXYZ * RotateYm25; // Unity_OculusVR -> Unreal_SteamVR
-                break;
-            }
-            break;
-        }
-        return;
-	} else { // vr_plugin == GestureRecognition_VRPlugin::OpenXR
-		switch (coord_sys) {
-		case GestureRecognition_CoordinateSystem::Unreal_OculusVR:
-		case GestureRecognition_CoordinateSystem::Unreal_OpenXR:
-		case GestureRecognition_CoordinateSystem::Unreal_SteamVR:
-            location.X = (float)p[0];
-            location.Y = (float)p[1];
-            location.Z = (float)p[2];
-            rotation.X = (float)q[0];
-            rotation.Y = (float)q[1];
-            rotation.Z = (float)q[2];
-            rotation.W = (float)q[3];
-            if (device_type == GestureRecognition_DeviceType::Controller) {
-				if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_SteamVR) {
-					rotation = rotation * RotateYm20; // Unreal_SteamVR -> Unreal_OpenXR
-				} else if (coord_sys == GestureRecognition_CoordinateSystem::Unreal_OculusVR) {
-					rotation = rotation * RotateYm55; // Unreal_OculusVR -> Unreal_OpenXR
-				}
-            }
-            return;
-        }
-        // else: one of the Unity coordinate systems
-        location.X = 100.0f * (float)p[2]; // Unreal.X = front = Unity.Z
-        location.Y = 100.0f * (float)p[0]; // Unreal.Y = right = Unity.X
-        location.Z = 100.0f * (float)p[1]; // Unreal.Z = up    = Unity.Y
-        rotation.X = (float)q[0]; // in Unity coordinates
-        rotation.Y = (float)q[1];
-        rotation.Z = (float)q[2];
-        rotation.W = (float)q[3];
-        rotation.Normalize();
-        rotation = RotateXZY * rotation;
-        switch (device_type) {
-        case GestureRecognition_DeviceType::Headset:
-            rotation = rotation * RotateXYZ;
-            break;
-        case GestureRecognition_DeviceType::Controller:
-            switch (coord_sys) {
-            case GestureRecognition_CoordinateSystem::Unity_OpenXR:
-				rotation = rotation * RotateXYZ; // Unity_OpenXR -> Unreal_OpenXR
-				break;
-            case GestureRecognition_CoordinateSystem::Unity_SteamVR:
-                rotation = rotation * RotateXYZ * RotateYm20; // Unity_SteamVR -> Unreal_OpenXR
-                break;
-            case GestureRecognition_CoordinateSystem::Unity_OculusVR:
-                rotation = rotation * RotateXYZ * RotateYm55; // Unity_OculusVR -> Unreal_OpenXR
-                break;
-            }
-            break;
-        }
-        return;
+	check(locations.Num() == rotations.Num());
+	// Positions and rotations in separate loops, so that the position loop can be vectorized.
+	const int32 num = locations.Num();
+	const int32 sx = OutputSwizzle[0];
+	const int32 sy = OutputSwizzle[1];
+	const int32 sz = OutputSwizzle[2];
+	const double scale = OutputScale;
+	for (int32 i = 0; i < num; i++) {
+		FVector& location = locations[i];
+		location.X = (float)(p[3 * i + sx] * scale);
+		location.Y = (float)(p[3 * i + sy] * scale);
+		location.Z = (float)(p[3 * i + sz] * scale);
 	}
+	for (int32 i = 0; i < num; i++) {
+		FQuat rotation((float)q[4 * i + 0], (float)q[4 * i + 1], (float)q[4 * i + 2], (float)q[4 * i + 3]);
+		if (OutputNormalize) {
+			rotation.Normalize();
+		}
+		rotations[i] = OutputPre * rotation * OutputPost;
+	}
+}
+
+void FMiVRyCoordinateConversion::convertOutputArray(const double* p, const double* q, TArrayView<FVector> locations, TArrayView<FRotator> rotations) const
+{
+	check(locations.Num() == rotations.Num());
+	const int32 num = locations.Num();
+	const int32 sx = OutputSwizzle[0];
+	const int32 sy = OutputSwizzle[1];
+	const int32 sz = OutputSwizzle[2];
+	const double scale = OutputScale;
+	for (int32 i = 0; i < num; i++) {
+		FVector& location = locations[i];
+		location.X = (float)(p[3 * i + sx] * scale);
+		location.Y = (float)(p[3 * i + sy] * scale);
+		location.Z = (float)(p[3 * i + sz] * scale);
+	}
+	for (int32 i = 0; i < num; i++) {
+		FQuat rotation((float)q[4 * i + 0], (float)q[4 * i + 1], (float)q[4 * i + 2], (float)q[4 * i + 3]);
+		if (OutputNormalize) {
+			rotation.Normalize();
+		}
+		rotations[i] = (OutputPre * rotation * OutputPost).Rotator();
+	}
+}
+
+void UMiVRyUtil::convertInput(const FVector& location, const FQuat& rotation, GestureRecognition_DeviceType device_type, GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, double p[3], double q[4])
+{
+	FMiVRyCoordinateConversion::get(vr_plugin, coord_sys, device_type).convertInput(location, rotation, p, q);
+}
+
+void UMiVRyUtil::convertOutput(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, const double p[3], const double q[4], GestureRecognition_DeviceType device_type, FVector& location, FQuat& rotation)
+{
+	FMiVRyCoordinateConversion::get(vr_plugin, coord_sys, device_type).convertOutput(p, q, location, rotation);
 }
@@ -0,0 +1,108 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MiVRyWorldSubsystem.h"
+#include "MiVRyActor.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+
+void UMiVRyWorldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	this->FrameDatabaseFiles.Empty();
+
+	const int32 NumActors = this->Actors.Num();
+	if (NumActors == 0) {
+		return;
+	}
+	TArray<TArray<AMiVRyActor::PoseSample>> Samples;
+	Samples.SetNum(NumActors);
+	for (int32 i = 0; i < NumActors; i++) {
+		AMiVRyActor* Actor = this->Actors[i];
+		if (Actor->ProcessingTask.IsValid()) {
+			Actor->flushBackgroundProcessing(); // the actor ticked in the background before it was registered
+		}
+		Actor->gatherFrameSamples(Samples[i]);
+	}
+	ParallelFor(NumActors, [this, &Samples](int32 i) {
+		AMiVRyActor* Actor = this->Actors[i];
+		for (const AMiVRyActor::PoseSample& Sample : Samples[i]) {
+			Actor->processPoseSample(Sample);
+		}
+	});
+	for (int32 i = 0; i < NumActors; i++) {
+		this->Actors[i]->dispatchIdentificationResults();
+	}
+}
+
+TStatId UMiVRyWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMiVRyWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UMiVRyWorldSubsystem::Deinitialize()
+{
+	this->DatabaseFiles.Empty();
+	this->FrameDatabaseFiles.Empty();
+	Super::Deinitialize();
+}
+
+void UMiVRyWorldSubsystem::registerActor(AMiVRyActor* Actor)
+{
+	if (Actor != nullptr) {
+		this->Actors.AddUnique(Actor);
+		Actor->SetActorTickEnabled(false); // gathering and processing is done in Tick of this subsystem
+	}
+}
+
+void UMiVRyWorldSubsystem::unregisterActor(AMiVRyActor* Actor)
+{
+	if (this->Actors.Remove(Actor) > 0) {
+		Actor->SetActorTickEnabled(true);
+	}
+}
+
+TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> UMiVRyWorldSubsystem::readDatabaseFile(const FString& Path, GestureRecognition_Result& Result)
+{
+	FString FullPath;
+	UMiVRyUtil::findFile(Path, Result, FullPath);
+	if (Result != GestureRecognition_Result::Then) {
+		this->DatabaseFiles.Remove(Path);
+		return nullptr;
+	}
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FullPath);
+	DatabaseFile* Cached = this->DatabaseFiles.Find(Path);
+	if (Cached != nullptr && Cached->TimeStamp == TimeStamp) {
+		TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Data = Cached->Data.Pin();
+		if (Data.IsValid()) {
+			return Data;
+		}
+	}
+	TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Data = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+	UMiVRyUtil::readFileToBuffer(FullPath, Result, *Data);
+	if (Result != GestureRecognition_Result::Then) {
+		this->DatabaseFiles.Remove(Path);
+		return nullptr;
+	}
+	DatabaseFile& Entry = this->DatabaseFiles.Add(Path);
+	Entry.Data = Data;
+	Entry.TimeStamp = TimeStamp;
+	this->FrameDatabaseFiles.Add(Data);
+	return Data;
+}
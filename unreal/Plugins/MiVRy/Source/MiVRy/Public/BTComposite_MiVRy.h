@@ -52,13 +52,24 @@ enum class UBTComposite_MiVRy_LatestGestureData : uint8
 	RightSecondaryDirection = 13 UMETA(DisplayName = "[Right] Secondary Direction (Vector)"),
 };
 
+/**
+* Number of different types of gesture data (UBTComposite_MiVRy_LatestGestureData).
+*/
+static constexpr int32 UBTComposite_MiVRy_NumLatestGestureData = 14;
+
 
 struct UBTComposite_MiVRyMemory : public FBTCompositeMemory
 {
 	/**
-	* Counter variable to detect new gesture performances/identifications.
+	* Counter of the latest gesture event of the MiVRy actor that this instance has consumed.
+	*/
+	uint32 LatestGestureCounter = 0;
+
+	/**
+	* The ID (index) of the gesture which was last identified,
+	* or -1 if identification failed.
 	*/
-	int LatestGestureCounter = 0;
+	int LatestGestureId = -1;
 };
 
 
@@ -74,13 +85,7 @@ class MIVRY_API UBTComposite_MiVRy : public UBTCompositeNode
 	GENERATED_BODY()
 	
 	UBTComposite_MiVRy(const FObjectInitializer& ObjectInitializer);
-	virtual ~UBTComposite_MiVRy();
-	virtual void PostLoad() override;
-	virtual void BeginDestroy() override;
-#if WITH_EDITOR
-	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
-#endif
-	virtual void NotifyNodeActivation(FBehaviorTreeSearchData& SearchData) const override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
 	virtual int32 GetNextChildHandler(struct FBehaviorTreeSearchData& SearchData, int32 PrevChild, EBTNodeResult::Type LastResult) const override;
 	virtual uint16 GetInstanceMemorySize() const override;
 	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
@@ -159,32 +164,6 @@ public:
 	bool DisplayGestureMappingInNode = false;
 
 private:
-	/**
-	* The ID (index) of the gesture which was last identified,
-	* or a negative error code if identification failed.
-	*/
-	int LatestGestureId = -1;
-
-	/**
-	* The name of the gesture which was last identified.
-	*/
-	FString LatestGestureName;
-
-	/**
-	* The similarity value of the gesture which was last identified.
-	*/
-	float LatestGestureSimilarity = -1;
-
-	/**
-	* The gesture motion parts of the gesture which was last identified.
-	*/
-	TArray<FMiVRyGesturePart> LatestGestureParts;
-
-	/**
-	* Counter variable to detect new gesture performances/identifications.
-	*/
-	int LatestGestureCounter = 0;
-
 	/**
 	* File path to the Gesture Database (.DAT) file used by MiVRyActor.
 	*/
@@ -196,32 +175,20 @@ private:
 	TArray<FString> GestureNames;
 
 	/**
-	* Delegate to re-route callbacks from MiVRyActor.
-	*/
-	FScriptDelegate Delegate;
-
-	/**
-	* If the delegate is bound, the bound-to MiVRyActor is stored here.
+	* Blackboard key IDs of LatestGestureBlackboardKeys, resolved when the behavior tree is loaded.
+	* Indexed by UBTComposite_MiVRy_LatestGestureData, FBlackboard::InvalidKey where not set.
 	*/
-	TSoftObjectPtr<AMiVRyActor> BoundMiVRyActor;
+	FBlackboard::FKey LatestGestureBlackboardKeyIds[UBTComposite_MiVRy_NumLatestGestureData];
 
 	/**
-	* Delegate function to be called by MiVRy Actor.
+	* Whether any of LatestGestureBlackboardKeyIds is valid.
 	*/
-	UFUNCTION()
-	void OnGestureIdentified(
-		AMiVRyActor* Source,
-		GestureRecognition_Identification Result,
-		int GestureID,
-		FString GestureName,
-		float Similarity,
-		const TArray<FMiVRyGesturePart>& GestureParts
-	);
+	bool HasLatestGestureBlackboardKeys = false;
 
 	/**
 	* Helper function to update the Blackboard variables
 	* set in LatestGestureBlackboardKeys with the
 	* gesture data of the last gesture.
 	*/
-	void SetLatestGestureBlackboardVars(UBlackboardComponent* BlackboardComponent) const;
+	void SetLatestGestureBlackboardVars(UBlackboardComponent* BlackboardComponent, const AMiVRyActor& Actor, const AMiVRyActor::GestureEvent& Event) const;
 };
@@ -35,9 +35,20 @@ enum class GestureRecognition_GestureIdListUse : uint8
 struct UBTDecorator_MiVRyMemory
 {
 	/**
-	* Counter variable to detect new gesture performances/identifications.
+	* Counter of the latest gesture event of the MiVRy actor that this instance has consumed.
 	*/
-	int LatestGestureCounter = 0;
+	uint32 LatestGestureCounter = 0;
+
+	/**
+	* The ID (index) of the gesture which was last identified,
+	* or -1 if identification failed.
+	*/
+	int LatestGestureId = -1;
+
+	/**
+	* Subscription to the MiVRy actor's gesture events while this decorator is relevant.
+	*/
+	FDelegateHandle GestureEventHandle;
 };
 
 /**
@@ -51,10 +62,7 @@ class MIVRY_API UBTDecorator_MiVRy : public UBTDecorator
 	GENERATED_BODY()
 
 	UBTDecorator_MiVRy(const FObjectInitializer& ObjectInitializer);
-	virtual ~UBTDecorator_MiVRy();
-	virtual void BeginDestroy() override;
-	virtual void PostLoad() override;
-	virtual void OnNodeActivation(FBehaviorTreeSearchData& SearchData) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
@@ -62,7 +70,8 @@ class MIVRY_API UBTDecorator_MiVRy : public UBTDecorator
 	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
 	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
-	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 	virtual FString GetStaticDescription() const override;
 	virtual void DescribeRuntimeValues(const UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTDescriptionVerbosity::Type Verbosity, TArray<FString>& Values) const override;
 
@@ -117,36 +126,30 @@ private:
 	TArray<FString> GestureNames;
 
 	/**
-	* Delegate function to be called by MiVRy Actor.
+	* GestureIDs as bits (indexed by gesture ID + 1, so that bit 0 is 'no gesture').
 	*/
-	UFUNCTION()
-	void OnGestureIdentified(
-		AMiVRyActor* Source,
-		GestureRecognition_Identification Result,
-		int GestureID,
-		FString GestureName,
-		float Similarity,
-		const TArray<FMiVRyGesturePart>& GestureParts
-	);
-
-	/**
-	* Delegate to re-route callbacks from MiVRyActor.
-	*/
-	FScriptDelegate Delegate;
+	TBitArray<> GestureIdBits;
 
 	/**
-	* If the delegate is bound, the bound-to MiVRyActor is stored here.
+	* Update GestureIdBits from GestureIDs.
 	*/
-	TSoftObjectPtr<AMiVRyActor> BoundMiVRyActor;
+	void CompileGestureIds();
 
 	/**
-	* The ID (index) of the gesture which was last identified,
-	* or a negative error code if identification failed.
+	* Whether a gesture ID is in the GestureIDs list.
 	*/
-	int LatestGestureId = -1;
+	bool IsGestureIdListed(int32 GestureId) const;
 
 	/**
-	* Counter variable to detect new gesture performances/identifications.
+	* Handler for gesture events of the MiVRy actor, while this decorator is relevant.
 	*/
-	int LatestGestureCounter = 0;
+	void OnGestureIdentified(
+		AMiVRyActor* Source,
+		GestureRecognition_Identification Result,
+		int GestureID,
+		const FString& GestureName,
+		float Similarity,
+		const TArray<FMiVRyGesturePart>& GestureParts,
+		TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp
+	);
 };
@@ -30,6 +30,11 @@ class MIVRY_API AGestureCombinationsActor : public AActor
 	GENERATED_BODY()
 private:
 	IGestureCombinations* gco = nullptr; //!< Gesture Combinations object.
+	TArray<uint8> AsyncLoadingBuffer; //!< Gesture database file contents, kept alive during asynchronous loading.
+	bool AsyncFileReading = false; //!< Whether a gesture database file is currently being read in the background (see loadFromFileAsync).
+	int32 AsyncFileReadingRequest = 0; //!< Counter to identify (and discard) outdated or cancelled background file reads.
+	FFilePath PendingSavePath; //!< Where to save once the currently running saving process finished (see requestAutosave).
+	bool SavePending = false; //!< Whether an autosave was requested while a saving process was running.
 
 public:	
 	// Sets default values for this actor's properties
@@ -387,6 +392,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gesture Combinations", meta = (DisplayName = "Copy Gesture"))
 	int copyGesture(int from_part, int from_gesture_index, int to_part, int to_gesture_index=-1, bool mirror=false);
 
+	/**
+	* Make one part/side the mirror image of another, for symmetric (eg. left and right hand) gestures.
+	* All gestures of the target part are replaced by mirrored copies of the gestures of the source part,
+	* with the same gesture IDs, so gesture combinations continue to refer to the same gestures.
+	* This way, gestures only have to be recorded with one hand.
+	* If copying fails, the target part is left unchanged.
+	* Gesture combinations which used a target part gesture without mirrored counterpart are logged (and keep no gesture for that part).
+	* @param from_part The combination part or hand side index from which to copy.
+	* @param to_part The combination part or hand side index which to replace with the mirrored gestures.
+	* @return Zero on success, a negative error code on failure (-18 if the parts are invalid).
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Gesture Combinations", meta = (DisplayName = "Mirror Part"))
+	int mirrorPart(int from_part, int to_part);
+
 	/**
 	* Get the gesture recognition score of the current neural network (0~1).
 	* @param part The combination part of hand side index for which to retrieve the score.
@@ -766,6 +785,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gesture Combinations", meta = (DisplayName = "Save GestureDatabase File Async"))
 	int saveToFileAsync(const FFilePath& path);
 
+	/**
+	* Save the neural network and recorded training data to file, asynchronously, coalescing repeated requests.
+	* If no saving process is running, this starts one immediately (same as 'saveToFileAsync').
+	* If a saving process is already running, the request is remembered and one new saving process
+	* is started after the current one finished, no matter how many requests were made in the meantime.
+	* This allows to autosave after every recorded sample without piling up saving processes.
+	* @param path Path where to save the gesture database file.
+	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* (or scheduling) the saving process.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Gesture Combinations", meta = (DisplayName = "Request Autosave to GestureDatabase File"))
+	int requestAutosave(const FFilePath& path);
+
 	/**
 	* Whether the Neural Network is currently saving to a file or buffer.
 	* @return   True if the AI is currently saving, false if not.
@@ -784,7 +815,7 @@ public:
 	* Load the neural network and recorded training data from file, asynchronously.
 	* The function will return immediately, while the loading process will continue in the background.
 	* Use 'isLoading' to check if the loading process is still ongoing.
-	* You can use 'OnTrainingFinishDelegate' to receive a notification when loading finishes.
+	* You can use 'OnLoadingUpdateDelegate' and 'OnLoadingFinishDelegate' (called on the game thread) to follow the loading progress.
 	* @param path Path to the gesture database file to load.
 	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* the loading process.
 	*/
@@ -795,7 +826,7 @@ public:
 	* Load the neural network and recorded training data buffer, asynchronously.
 	* The function will return immediately, while the loading process will continue in the background.
 	* Use 'isLoading' to check if the loading process is still ongoing.
-	* You can use 'OnTrainingFinishDelegate' to receive a notification when loading finishes.
+	* You can use 'OnLoadingUpdateDelegate' and 'OnLoadingFinishDelegate' (called on the game thread) to follow the loading progress.
 	* @param buffer The gesture database to load.
 	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* the loading process.
 	*/
@@ -965,6 +996,14 @@ public:
 	*/
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTrainingCallbackDelegate, AGestureCombinationsActor*, Source, float, Performance);
 
+	/**
+	* Delegate for per-part training callbacks.
+	* @param Source The GestureCombinationsActor from which the callback originated.
+	* @param Part The index of the part (sub-gesture).
+	* @param Performance The gesture recognition performance of the part (0~1).
+	*/
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FPartTrainingCallbackDelegate, AGestureCombinationsActor*, Source, int, Part, float, Performance);
+
 	/**
 	* Delegate for loading callbacks.
 	* @param Source The GestureCombinationsActor from which the callback originated.
@@ -991,6 +1030,13 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "GestureCombinations Training Events")
 		FTrainingCallbackDelegate OnTrainingFinishDelegate;
 
+	/**
+	* Delegate to be called for every part when training was finished (or stopped),
+	* with the recognition performance of that part's neural network.
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "GestureCombinations Training Events")
+		FPartTrainingCallbackDelegate OnPartTrainingFinishDelegate;
+
 	/**
 	* Delegate to be called (repeatedly) during loading.
 	*/
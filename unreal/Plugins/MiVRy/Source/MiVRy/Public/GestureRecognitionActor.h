@@ -30,6 +30,11 @@ class MIVRY_API AGestureRecognitionActor : public AActor
 	GENERATED_BODY()
 private:
 	IGestureRecognition* gro = nullptr; //!< Gesture Recognition object.
+	TArray<uint8> AsyncLoadingBuffer; //!< Gesture database file contents, kept alive during asynchronous loading.
+	bool AsyncFileReading = false; //!< Whether a gesture database file is currently being read in the background (see loadFromFileAsync).
+	int32 AsyncFileReadingRequest = 0; //!< Counter to identify (and discard) outdated or cancelled background file reads.
+	FFilePath PendingSavePath; //!< Where to save once the currently running saving process finished (see requestAutosave).
+	bool SavePending = false; //!< Whether an autosave was requested while a saving process was running.
 
 public:	
 	// Sets default values for this actor's properties
@@ -612,6 +617,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gesture Recognition", meta = (DisplayName = "Save GestureDatabase File Async"))
 	int saveToFileAsync(const FFilePath& path);
 
+	/**
+	* Save the neural network and recorded training data to file, asynchronously, coalescing repeated requests.
+	* If no saving process is running, this starts one immediately (same as 'saveToFileAsync').
+	* If a saving process is already running, the request is remembered and one new saving process
+	* is started after the current one finished, no matter how many requests were made in the meantime.
+	* This allows to autosave after every recorded sample without piling up saving processes.
+	* @param path Path where to save the gesture database file.
+	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* (or scheduling) the saving process.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Gesture Recognition", meta = (DisplayName = "Request Autosave to GestureDatabase File"))
+	int requestAutosave(const FFilePath& path);
+
 	/**
 	* Whether the Neural Network is currently saving to a file or buffer.
 	* @return   True if the AI is currently saving, false if not.
@@ -630,7 +647,7 @@ public:
 	* Load the neural network and recorded training data from file, asynchronously.
 	* The function will return immediately, while the loading process will continue in the background.
 	* Use 'isLoading' to check if the loading process is still ongoing.
-	* You can use 'OnTrainingFinishDelegate' to receive a notification when loading finishes.
+	* You can use 'OnLoadingUpdateDelegate' and 'OnLoadingFinishDelegate' (called on the game thread) to follow the loading progress.
 	* @param path Path to the gesture database file to load.
 	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* the loading process.
 	*/
@@ -641,7 +658,7 @@ public:
 	* Load the neural network and recorded training data buffer, asynchronously.
 	* The function will return immediately, while the loading process will continue in the background.
 	* Use 'isLoading' to check if the loading process is still ongoing.
-	* You can use 'OnTrainingFinishDelegate' to receive a notification when loading finishes.
+	* You can use 'OnLoadingUpdateDelegate' and 'OnLoadingFinishDelegate' (called on the game thread) to follow the loading progress.
 	* @param buffer The gesture database to load.
 	* @return Zero on success, a negative error code on failure. Note that this only relates to *starting* the loading process.
 	*/
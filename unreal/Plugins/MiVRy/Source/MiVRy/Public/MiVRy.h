@@ -19,6 +19,17 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Logging/LogMacros.h"
+
+/**
+* Log category of the MiVRy plug-in.
+* In shipping builds, messages below Warning are compiled out.
+*/
+#if UE_BUILD_SHIPPING
+MIVRY_API DECLARE_LOG_CATEGORY_EXTERN(LogMiVRy, Log, Warning);
+#else
+MIVRY_API DECLARE_LOG_CATEGORY_EXTERN(LogMiVRy, Log, All);
+#endif
 
 class FMiVRyModule : public IModuleInterface
 {
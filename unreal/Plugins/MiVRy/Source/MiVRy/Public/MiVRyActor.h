@@ -22,10 +22,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "InputAction.h"
+#include "Containers/Queue.h"
+#include "Containers/CircularQueue.h"
+#include "Async/Future.h"
 #include "MiVRyActor.generated.h"
 
 class IGestureRecognition;
 class IGestureCombinations;
+class UMiVRyWorldSubsystem;
+class UMiVRyGestureDatabase;
 
 USTRUCT(BlueprintType)
 struct FMiVRyGesturePart
@@ -111,6 +116,20 @@ public:
 	UPROPERTY(EditAnywhere, Category = "MiVRy", meta = (RelativePath))
 		FFilePath GestureDatabaseFile;
 
+	/**
+	* Gesture database asset from which to load pre-recorded gestures.
+	* If set, this is used instead of the GestureDatabaseFile.
+	*/
+	UPROPERTY(EditAnywhere, Category = "MiVRy")
+		UMiVRyGestureDatabase* GestureDatabase = nullptr;
+
+	/**
+	* Whether to load the GestureDatabaseFile on a worker thread instead of during BeginPlay.
+	* Gesturing can only be started after loading finished (see OnDatabaseLoadedDelegate).
+	*/
+	UPROPERTY(EditAnywhere, Category = "MiVRy")
+		bool LoadDatabaseAsynchronously = false;
+
 	/**
 	* Which VR plug-in you're using in your project.
 	* By default, UE5 uses OpenXR plug-in as other plug-ins have been deprecated.
@@ -248,6 +267,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MiVRy")
 		bool CompensateHeadMotion = false;
 
+	/**
+	* Whether to run gesture data ingestion and continuous identification on a worker thread
+	* instead of the game thread.
+	* When enabled, the controller/headset poses are only gathered during Tick and
+	* identification results are delivered (OnGestureIdentifiedDelegate) on a later game thread Tick.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MiVRy")
+		bool ProcessInBackground = false;
+
+	/**
+	* Rate (in samples per second) at which controller motion is fed to MiVRy.
+	* When set, the poses gathered every frame are resampled at this fixed rate (interpolating between frames),
+	* so that the gesture data density does not depend on the frame rate.
+	* Note that the resampled poses of a frame are still passed to MiVRy together, without timestamps:
+	* MiVRy's own timing (eg. ContinuousGesturePeriod) keeps measuring time as the samples arrive, once per frame.
+	* Set to zero to use one sample per frame.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MiVRy", meta = (ClampMin = "0", UIMax = "240"))
+		float SamplingRate = 0.0f;
+
+	/**
+	* Whether this actor should be processed by the MiVRy world subsystem
+	* (together with all other MiVRy actors in the world, in one parallel batch)
+	* instead of in its own Tick. Overrides ProcessInBackground.
+	*/
+	UPROPERTY(EditAnywhere, Category = "MiVRy")
+		bool TickInWorldSubsystem = false;
+
 	/**
 	* License ID (name) of your MiVRy license.
 	* Leave emtpy for free version.
@@ -282,6 +329,34 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Is Gesturing"))
 		bool IsGesturing(GestureRecognition_Side side = GestureRecognition_Side::Left);
 
+	/**
+	* Get whether a hand (side) is currently used (enabled) for gesture identification.
+	* @param side Which hand (left or right).
+	* @return True if the side is used/enabled, false if it was disabled.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Get Part Enabled"))
+		bool getPartEnabled(GestureRecognition_Side side = GestureRecognition_Side::Left) const;
+
+	/**
+	* Set whether a hand (side) is used for gesture identification (GestureCombinations databases only).
+	* The poses of disabled sides are not gathered nor processed, so disabling unused sides
+	* (eg. for game states in which only one-handed gestures are possible) saves per-frame work.
+	* Disabled sides cannot start gesturing, and disabling a side which is gesturing cancels its gesture.
+	* @param Result Whether the function succeded or failed.
+	* @param ErrorCode Error code if the function failed, 0 if it succeeded.
+	* @param side Which hand (left or right).
+	* @param enabled Whether the side should be used or disabled.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Set Part Enabled", ExpandEnumAsExecs = "Result"))
+		void setPartEnabled(GestureRecognition_Result& Result, int& ErrorCode, GestureRecognition_Side side, bool enabled);
+
+	/**
+	* Whether the gesture database file is still being loaded (see LoadDatabaseAsynchronously).
+	* @return True if the gesture database is currently loading, false if not.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Is Database Loading"))
+		bool IsDatabaseLoading() const;
+
 	/**
 	* End a gesture motion.
 	* The gesture will be identified if no other hand is currently gesturing.
@@ -302,6 +377,47 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Get Identified Gesture Info", ExpandEnumAsExecs = "Result"))
 		void getIdentifiedGestureInfo(GestureRecognition_Result& Result, int& GestureID, FString& GestureName, float& Similarity, TArray<FMiVRyGesturePart>& GestureParts) const;
 
+	/**
+	* Get all gesture combinations which use a certain gesture for one of their parts.
+	* Uses the index built when the gesture database was loaded (GestureCombinations databases only).
+	* @param Part The index of the part (0=left hand, 1=right hand for two-handed gestures).
+	* @param PartGestureID The ID of the gesture of the part.
+	* @param GestureCombinationIDs [OUT] The IDs of the gesture combinations using this part gesture.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", meta = (DisplayName = "Get Gesture Combinations Using Part Gesture"))
+		void getGestureCombinationsUsingPartGesture(int Part, int PartGestureID, TArray<int>& GestureCombinationIDs) const;
+
+	/**
+	* Restrict gesture identification to a subset of the gestures (or gesture combinations).
+	* Other gestures are never reported as identified, eg. for game states in which only some gestures are possible.
+	* The candidate set applies to both continuous and non-continuous identification until it is cleared.
+	* MiVRy still evaluates all gestures; the candidate set is applied to its results:
+	* - GestureRecognition databases: the most probable candidate gesture is identified, with its own similarity.
+	* - GestureCombinations databases (when gesturing stops): the candidate combinations are ranked by the geometric mean
+	*   of their part gesture probabilities, each renormalized over the part gestures used by the candidates.
+	*   If the best candidate is not MiVRy's own best match, its similarity is the mean of its part similarities.
+	* - GestureCombinations databases (continuous identification): the part probabilities may be outdated for parts which
+	*   are not currently gesturing, so MiVRy's result is only reported if it is one of the candidates.
+	* @param Result Whether the function succeded or failed.
+	* @param ErrorCode Error code if the function failed, 0 if it succeeded.
+	* @param GestureIDs The IDs of the gestures (or gesture combinations) which can be identified. Empty to allow all gestures.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Set Candidate Gestures", ExpandEnumAsExecs = "Result"))
+		void setCandidateGestures(GestureRecognition_Result& Result, int& ErrorCode, const TArray<int>& GestureIDs);
+
+	/**
+	* Remove the restriction set with setCandidateGestures so that all gestures can be identified again.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Clear Candidate Gestures"))
+		void clearCandidateGestures();
+
+	/**
+	* Get the gestures (or gesture combinations) to which identification is currently restricted.
+	* @param GestureIDs [OUT] The IDs of the candidate gestures, or empty if all gestures can be identified.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Get Candidate Gestures"))
+		void getCandidateGestures(TArray<int>& GestureIDs) const;
+
 	/**
 	* Retrieve a 3d gesture path that is the representative average of a gesture part.
 	* The coordinate system used is a standardized gesture coordinate system, where the x-axis
@@ -334,19 +450,150 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Gesture Identification Events")
 		FGestureIdentificationCallbackDelegate OnGestureIdentifiedDelegate;
 
+	DECLARE_MULTICAST_DELEGATE_SixParams(FGestureIdentificationNativeDelegate,
+		AMiVRyActor* /*Source*/,
+		GestureRecognition_Identification /*Result*/,
+		int /*GestureID*/,
+		const FString& /*GestureName*/,
+		float /*Similarity*/,
+		const TArray<FMiVRyGesturePart>& /*GestureParts*/
+	);
+
+	/**
+	* Native (C++) counterpart of OnGestureIdentifiedDelegate.
+	* The gesture name and parts are passed by reference from buffers owned by the actor,
+	* so broadcasting does not allocate. The references are only valid during the callback.
+	*/
+	FGestureIdentificationNativeDelegate OnGestureIdentifiedNative;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDatabaseLoadedCallbackDelegate, AMiVRyActor*, Source, int, ErrorCode);
+
+	/**
+	* Delegate to be called when loading the gesture database file finished (ErrorCode is zero on success).
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Gesture Identification Events")
+		FDatabaseLoadedCallbackDelegate OnDatabaseLoadedDelegate;
+
+	/**
+	* A gesture identification event, kept in a short history for consumers which read
+	* the latest events instead of subscribing (eg. behavior tree nodes).
+	*/
+	struct GestureEvent {
+		GestureRecognition_Identification result = GestureRecognition_Identification::FailedToIdentify; //!< Result of the identification.
+		int gesture_id = -1; //!< Identified gesture ID, or -1 on failure.
+		float similarity = -1.0f; //!< Identified gesture's similarity.
+		TArray<FMiVRyGesturePart, TInlineAllocator<2>> parts; //!< Identified gesture's parts (databases with more than two parts allocate).
+	};
+	static constexpr uint32 GestureEventHistorySize = 16; //!< Number of recent gesture events kept by the actor.
+	uint32 getGestureEventCounter() const { return this->GestureEventCounter; } //!< Number of gesture events so far (game thread).
+	const GestureEvent* getGestureEvent(uint32 counter) const; //!< Gesture event number 'counter' (1-based), nullptr if not (or no longer) available.
+	const FString& getCachedGestureName(int id) const; //!< Cached name of a gesture (or gesture combination), empty if unknown.
+
 	AMiVRyActor(); //!< Constructor.
 	virtual ~AMiVRyActor(); //!< Destructor.
 	virtual void Tick(float DeltaTime) override; //!< Called every frame.
 protected:
 	virtual void BeginPlay() override; //!< Called when the game starts or when spawned.
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override; //!< Called when the game ends or when destroyed.
 	void SetupPlayerInputComponent(class UInputComponent* InputComponent); //!< Bind the input component actions.
+	static int loadDatabase(const FString& path, GestureRecognition_Result read_result, const TArray<uint8>& file_contents, IGestureRecognition*& loaded_gro, IGestureCombinations*& loaded_gco); //!< Create and load the gesture recognition/combinations object (any thread).
+	void finishLoadingDatabase(IGestureRecognition* loaded_gro, IGestureCombinations* loaded_gco, int ret); //!< Take over the loaded object and activate the license (game thread).
 	
 	IGestureRecognition* gro = nullptr; //!< The GestureRecognition object in use (if any).
 	IGestureCombinations* gco = nullptr; //!< The GestureCombinations object in use (if any).
+	bool DatabaseLoading = false; //!< Whether the gesture database is currently being loaded (LoadDatabaseAsynchronously).
 	bool side_active[2] = { false, false }; //!< Which hand (side) is currently gesturing (if any).
+	bool side_enabled[2] = { true, true }; //!< Which hand (side) is used for gesture identification (see setPartEnabled).
 	TArray<FMiVRyGesturePart> parts; //!< Temporary storage for gesture parts.
 	int gesture_id = -1; //!< Last identified gesture ID, or error code.
 	double similarity = -1.0; //!< Last identified gesture's similarity.
+	TArray<FString> GestureNames; //!< Names of the gestures (or gesture combinations) by ID, cached when the database is loaded.
+	int NumCombinationParts = 0; //!< Number of parts per gesture combination (GestureCombinations databases only).
+	TArray<int> CombinationPartGestures; //!< Gesture ID of each part of each combination, at [combination * NumCombinationParts + part].
+	TMultiMap<uint64, int> PartGestureCombinations; //!< Combinations using a part gesture, keyed by (part << 32 | gesture ID). Used to find candidate combinations to score.
+	int getCombinationPartGesture(int combination, int part) const; //!< Gesture ID of a combination's part, or -1.
+	TBitArray<> CandidateGestures; //!< Gestures (or combinations) which can be identified, indexed by ID. Empty: all (see setCandidateGestures).
+	TArray<double> CandidateProbabilities; //!< Scratch buffer for per-gesture probabilities when identifying among candidates.
+	TArray<double> CandidateSimilarities; //!< Scratch buffer for per-gesture similarities when identifying among candidates.
+	int identifyCandidateGesture(const double* p, const double* s, int n, double& sim) const; //!< Most probable candidate gesture, or -1 if none.
+	static constexpr double MinCandidatePartProbability = 0.01; //!< Renormalized part gesture probability below which the candidate combinations using it are not looked up.
+	TBitArray<> CandidatePartGestures[2]; //!< Part gestures used by the candidate combinations, indexed by part and gesture ID (see setCandidateGestures).
+	int identifyCandidateCombination(int identified_id, double& sim); //!< Most probable candidate combination after a performed gesture (see setCandidateGestures), or a negative error code.
+	GestureEvent GestureEvents[GestureEventHistorySize]; //!< Ring buffer of recent gesture events (see getGestureEvent).
+	uint32 GestureEventCounter = 0; //!< Number of gesture events so far.
+	void broadcastGestureIdentified(GestureRecognition_Identification Result); //!< Notify listeners about the last identification (game thread).
+
+	/**
+	* Controller (and headset) pose of one side, converted to MiVRy coordinates, to be processed by MiVRy.
+	*/
+	struct PoseSample {
+		int side = 0; //!< Which hand (side) this pose sample belongs to.
+		double time = 0; //!< When the pose was sampled (world real time, in seconds). Only used for resampling, not passed to MiVRy.
+		bool identify = true; //!< Whether to run continuous identification after this sample (last sample of a batch).
+		double p[3] = { 0, 0, 0 }; //!< Controller position.
+		double q[4] = { 0, 0, 0, 1 }; //!< Controller rotation.
+		double hmd_p[3] = { 0, 0, 0 }; //!< Headset position (if CompensateHeadMotion).
+		double hmd_q[4] = { 0, 0, 0, 1 }; //!< Headset rotation (if CompensateHeadMotion).
+		bool compensate_head_motion = false; //!< Value of CompensateHeadMotion when the sample was taken.
+		GestureRecognition_ContinuousIdentification continuous = GestureRecognition_ContinuousIdentification::Off; //!< Value of ContinuousGestureRecognition when the sample was taken.
+		int period = 1000; //!< Value of ContinuousGesturePeriod when the sample was taken.
+		int smoothing = 3; //!< Value of ContinuousGestureSmoothing when the sample was taken.
+		GestureRecognition_CoordinateSystem coordinate_system = GestureRecognition_CoordinateSystem::Unreal_OpenXR; //!< Value of MivryCoordinateSystem when the sample was taken.
+	};
+
+	/**
+	* Result of a continuous identification, to be delivered on the game thread.
+	*/
+	struct IdentificationResult {
+		int gesture_id = -1; //!< Identified gesture ID, or error code.
+		double similarity = -1.0; //!< Identified gesture's similarity.
+		TArray<FMiVRyGesturePart, TInlineAllocator<2>> parts; //!< Identified gesture's parts (databases with more than two parts allocate).
+	};
+	static constexpr uint32 IdentificationResultQueueSize = 64; //!< Capacity (plus one) of the identification result queue.
+
+	TQueue<PoseSample, EQueueMode::Spsc> PoseSampleQueue; //!< Pose samples waiting to be processed (ProcessInBackground).
+	TCircularQueue<IdentificationResult> IdentificationResultQueue{ IdentificationResultQueueSize }; //!< Identification results waiting to be delivered on the game thread (preallocated, single producer and consumer).
+	void enqueueIdentificationResult(IdentificationResult&& result); //!< Queue an identification result for delivery on the game thread (any thread).
+	TFuture<void> ProcessingTask; //!< Background task processing the pose sample queue (if any).
+	mutable FCriticalSection ProcessingMutex; //!< Guards gro/gco while they are used by the background task.
+	UMiVRyWorldSubsystem* WorldSubsystem = nullptr; //!< The world subsystem processing this actor (TickInWorldSubsystem).
+
+	/**
+	* Average (mean) path of a gesture part, converted to Unreal coordinates (see getGesturePartAveragePath).
+	*/
+	struct AveragePath {
+		TArray<FVector> Locations;
+		TArray<FRotator> Rotations;
+		FVector GestureLocation = FVector::ZeroVector;
+		FRotator GestureRotation = FRotator::ZeroRotator;
+		float GestureScale = 1.0f;
+	};
+	TMap<uint64, AveragePath> AveragePathCache; //!< Average paths by part side and gesture ID, built on first use.
+	GestureRecognition_VRPlugin AveragePathCacheVRPlugin = GestureRecognition_VRPlugin::OpenXR; //!< UnrealVRPlugin with which the AveragePathCache was built.
+	GestureRecognition_CoordinateSystem AveragePathCacheCoordinateSystem = GestureRecognition_CoordinateSystem::Unreal_OpenXR; //!< MivryCoordinateSystem with which the AveragePathCache was built.
+	bool buildGesturePartAveragePath(const FMiVRyGesturePart& part, AveragePath& path) const; //!< Query and convert the average path of a gesture part.
+
+	PoseSample LastPoseSample[2]; //!< The previously gathered pose per side (SamplingRate).
+	bool HasLastPoseSample[2] = { false, false }; //!< Whether LastPoseSample is valid per side (SamplingRate).
+	double NextSampleTime[2] = { 0, 0 }; //!< When the next fixed-rate sample is due per side (SamplingRate).
+
+	bool ControllerTrackingLost[2] = { false, false }; //!< Whether the loss of controller tracking was logged per side.
+	bool HeadsetTrackingLost = false; //!< Whether the loss of the camera position was logged.
+	int LastProcessingError = 0; //!< Last logged error of processPoseSample (zero if none).
+	int LastHeadPositionError = 0; //!< Last logged error of updateHeadPositionQ (zero if none).
+	int LastStrokeError[2] = { 0, 0 }; //!< Last logged error of contdStrokeQ per side (zero if none).
+	int LastIdentificationError = 0; //!< Last logged error of continuous identification (zero if none).
+
+	void gatherFrameSamples(TArray<PoseSample>& samples); //!< Gather (and resample) the pose samples of this frame (game thread).
+	void gatherPoseSamples(TArray<PoseSample, TInlineAllocator<2>>& samples); //!< Gather the current controller/headset poses (game thread).
+	void resamplePoseSamples(const TArray<PoseSample, TInlineAllocator<2>>& samples, TArray<PoseSample>& resampled); //!< Resample gathered poses at the fixed SamplingRate (game thread).
+	int AppliedContinuousPeriod[2] = { -1, -1 }; //!< ContinuousGesturePeriod last set on the gesture object per side (-1 if not yet set).
+	int AppliedContinuousSmoothing[2] = { -1, -1 }; //!< ContinuousGestureSmoothing last set on the gesture object per side (-1 if not yet set).
+	void applyContinuousSettings(int side, int period, int smoothing); //!< Set continuous identification settings on the gesture object, if they changed.
+	void processPoseSample(const PoseSample& sample); //!< Feed a pose sample to MiVRy and queue identification results.
+	void processQueuedSamples(); //!< Process all queued pose samples.
+	void dispatchIdentificationResults(); //!< Deliver queued identification results (game thread).
+	void flushBackgroundProcessing(); //!< Wait for the background task and process/deliver everything still queued (game thread).
 
 	void LeftTriggerInputPressed();
 	void LeftTriggerInputReleased();
@@ -356,4 +603,6 @@ protected:
 	void EnhancedInputLeftTrigger(const FInputActionValue& Value);
 	void EnhancedInputRightTrigger(const FInputActionValue& Value);
 	float EnhancedInputTriggerValue(const FInputActionValue& Value);
+
+	friend class UMiVRyWorldSubsystem;
 };
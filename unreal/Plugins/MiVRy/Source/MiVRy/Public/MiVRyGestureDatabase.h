@@ -0,0 +1,107 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "MiVRyUtil.h"
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Runtime/Launch/Resources/Version.h" // for ENGINE_MAJOR_VERSION / ENGINE_MINOR_VERSION
+#include "MiVRyGestureDatabase.generated.h"
+
+struct FAssetData;
+
+/**
+* Gesture database asset.
+* Contains the contents of a MiVRy gesture database file, so that it is cooked into the
+* packaged project and can be referenced by MiVRy actors and behavior tree nodes
+* instead of a file path.
+* The database type and gesture names are stored alongside (and available as asset registry tags),
+* so they can be looked up without parsing the database.
+*/
+UCLASS(BlueprintType)
+class MIVRY_API UMiVRyGestureDatabase : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* The contents of the gesture database file (uncompressed).
+	*/
+	UPROPERTY()
+		TArray<uint8> Data;
+
+	/**
+	* Whether the database contains a one-part GestureRecognition or a multi-part GestureCombinations object.
+	*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MiVRy", AssetRegistrySearchable)
+		GestureRecognition_DatabaseType Type = GestureRecognition_DatabaseType::GestureRecognition;
+
+	/**
+	* The names of the identifiable gestures (gesture combinations for GestureCombinations databases).
+	*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MiVRy")
+		TArray<FString> GestureNames;
+
+	/**
+	* Replace the contents of this asset with a gesture database.
+	* @param Buffer The contents of a gesture database file (compressed or uncompressed).
+	* @param Result Whether the data could be read as a gesture database.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "MiVRy", Meta = (DisplayName = "Import Gesture Database", ExpandEnumAsExecs = "Result"))
+		void importFromBuffer(const TArray<uint8>& Buffer, GestureRecognition_Result& Result);
+
+	/**
+	* Read the gesture names of a gesture database asset from the asset registry, without loading it.
+	* @param AssetData The asset registry entry of the gesture database asset.
+	* @param Names [OUT] The gesture names.
+	* @return True if the asset registry entry contains gesture names, false otherwise.
+	*/
+	static bool getGestureNames(const FAssetData& AssetData, TArray<FString>& Names);
+
+	/**
+	* Get the gesture names of a gesture database asset, from its asset registry tags if available.
+	* @param Database The gesture database asset.
+	* @param Names [OUT] The gesture names.
+	*/
+	static void getGestureNames(const UMiVRyGestureDatabase* Database, TArray<FString>& Names);
+
+	static const FName GestureNamesTag; //!< Asset registry tag with the gesture names, one per line.
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4
+	virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
+#else
+	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+#endif
+
+#if WITH_EDITORONLY_DATA
+	/**
+	* Gesture database file from which to import (see "Import From Source File").
+	*/
+	UPROPERTY(EditAnywhere, Category = "MiVRy", meta = (RelativePath))
+		FFilePath SourceFile;
+#endif
+
+#if WITH_EDITOR
+	/**
+	* Import the gesture database from SourceFile.
+	*/
+	UFUNCTION(CallInEditor, Category = "MiVRy", Meta = (DisplayName = "Import From Source File"))
+		void importFromSourceFile();
+#endif
+};
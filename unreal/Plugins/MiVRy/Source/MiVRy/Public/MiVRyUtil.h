@@ -123,6 +123,139 @@ enum class GestureRecognition_VRPlugin : uint8
     OculusVR = 2 UMETA(DisplayName = "OculusVR"),
 };
 
+/**
+* Type of gesture recognition object stored in a gesture database file.
+*/
+UENUM(BlueprintType)
+enum class GestureRecognition_DatabaseType : uint8
+{
+    GestureRecognition = 0 UMETA(DisplayName = "Gesture Recognition (one part)"),
+    GestureCombinations = 1 UMETA(DisplayName = "Gesture Combinations (multi-part)"),
+};
+
+/**
+* Information about one part (hand, side) of a gesture database.
+*/
+USTRUCT(BlueprintType)
+struct FMiVRyDatabasePartInfo
+{
+    GENERATED_BODY()
+
+    /**
+    * The names of the gestures registered for this part.
+    */
+    UPROPERTY(BlueprintReadOnly, Category = "MiVRy")
+    TArray<FString> GestureNames;
+};
+
+/**
+* Information about the contents of a gesture database file.
+*/
+USTRUCT(BlueprintType)
+struct FMiVRyDatabaseInfo
+{
+    GENERATED_BODY()
+
+    /**
+    * Whether the database contains a one-part GestureRecognition or a multi-part GestureCombinations object.
+    */
+    UPROPERTY(BlueprintReadOnly, Category = "MiVRy")
+    GestureRecognition_DatabaseType Type = GestureRecognition_DatabaseType::GestureRecognition;
+
+    /**
+    * The parts (hands, sides) and their gestures. GestureRecognition databases always have one part.
+    */
+    UPROPERTY(BlueprintReadOnly, Category = "MiVRy")
+    TArray<FMiVRyDatabasePartInfo> Parts;
+
+    /**
+    * The names of the gesture combinations (empty for GestureRecognition databases).
+    */
+    UPROPERTY(BlueprintReadOnly, Category = "MiVRy")
+    TArray<FString> GestureCombinationNames;
+
+    /**
+    * The names of the gestures that can be identified with this database:
+    * the gesture names for GestureRecognition databases, the gesture combination names for GestureCombinations databases.
+    */
+    const TArray<FString>& identifiableGestureNames() const
+    {
+        static const TArray<FString> none;
+        if (Type == GestureRecognition_DatabaseType::GestureCombinations) {
+            return GestureCombinationNames;
+        }
+        return (Parts.Num() > 0) ? Parts[0].GestureNames : none;
+    }
+};
+
+/**
+* Precomputed conversion between UnrealEngine coordinates and internal MiVRy coordinates
+* for one combination of UE VR plugin, MiVRy coordinate system, and device type.
+* Positions are swizzled and scaled, rotations are converted with one pre- and one post-rotation:
+* rotation (MiVRy) = InputPre * rotation (Unreal) * InputPost.
+*/
+struct MIVRY_API FMiVRyCoordinateConversion
+{
+    int32 InputSwizzle[3] = { 0, 1, 2 }; //!< p[i] = location[InputSwizzle[i]] * InputScale
+    double InputScale = 1.0; //!< Scale from Unreal units to MiVRy units.
+    FQuat InputPre = FQuat::Identity; //!< Rotation applied before the Unreal rotation.
+    FQuat InputPost = FQuat::Identity; //!< Rotation applied after the Unreal rotation.
+    int32 OutputSwizzle[3] = { 0, 1, 2 }; //!< location[i] = p[OutputSwizzle[i]] * OutputScale
+    double OutputScale = 1.0; //!< Scale from MiVRy units to Unreal units.
+    FQuat OutputPre = FQuat::Identity; //!< Rotation applied before the MiVRy rotation.
+    FQuat OutputPost = FQuat::Identity; //!< Rotation applied after the MiVRy rotation.
+    bool OutputNormalize = false; //!< Whether to normalize MiVRy rotations before converting them.
+
+    FMiVRyCoordinateConversion() = default;
+    FMiVRyCoordinateConversion(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, GestureRecognition_DeviceType device_type);
+
+    /**
+    * Get the (precomputed) conversion for a UE VR plugin, MiVRy coordinate system, and device type.
+    * @param vr_plugin          The UE VR plugin used in this project.
+    * @param coord_sys          The internal coordinate system used by MiVRy.
+    * @param device_type        Whether the device is a VR handheld controller, a headset, or neither.
+    * @return The coordinate conversion.
+    */
+    static const FMiVRyCoordinateConversion& get(GestureRecognition_VRPlugin vr_plugin, GestureRecognition_CoordinateSystem coord_sys, GestureRecognition_DeviceType device_type);
+
+    /**
+    * Convert UnrealEngine coordinates to internal MiVRy coordinates.
+    * @param location           The position in Unreal coordinates.
+    * @param rotation           The rotation in Unreal coordinates.
+    * @param p                  [OUT] The translation in MiVRy's internal coordinates.
+    * @param q                  [OUT] The rotation quaternion in MiVRy's internal coordinates.
+    */
+    void convertInput(const FVector& location, const FQuat& rotation, double p[3], double q[4]) const;
+
+    /**
+    * Convert internal MiVRy coordinates to UnrealEngine coordinates.
+    * @param p                  The location in MiVRy's internal coordinate system.
+    * @param q                  The orientation in MiVRy's internal coordinate system.
+    * @param location           [OUT] UnrealEngine coordinate location.
+    * @param rotation           [OUT] UnrealEngine coordinate orientation.
+    */
+    void convertOutput(const double p[3], const double q[4], FVector& location, FQuat& rotation) const;
+
+    /**
+    * Convert a series of UnrealEngine coordinates to internal MiVRy coordinates.
+    * @param locations          The positions in Unreal coordinates.
+    * @param rotations          The rotations in Unreal coordinates (same number as locations).
+    * @param p                  [OUT] The translations in MiVRy's internal coordinates (3 per location).
+    * @param q                  [OUT] The rotation quaternions in MiVRy's internal coordinates (4 per rotation).
+    */
+    void convertInputArray(TArrayView<const FVector> locations, TArrayView<const FQuat> rotations, double* p, double* q) const;
+
+    /**
+    * Convert a series of internal MiVRy coordinates to UnrealEngine coordinates.
+    * @param p                  The locations in MiVRy's internal coordinate system (3 per point).
+    * @param q                  The orientations in MiVRy's internal coordinate system (4 per point).
+    * @param locations          [OUT] UnrealEngine coordinate locations (one per point).
+    * @param rotations          [OUT] UnrealEngine coordinate orientations (one per point).
+    */
+    void convertOutputArray(const double* p, const double* q, TArrayView<FVector> locations, TArrayView<FQuat> rotations) const;
+    void convertOutputArray(const double* p, const double* q, TArrayView<FVector> locations, TArrayView<FRotator> rotations) const;
+};
+
 /**
  * Utility function class for the MiVRy Gesture Recognition plug-in.
  */
@@ -172,6 +305,72 @@ public:
     UFUNCTION(BlueprintCallable, Category = "MiVRy Util", Meta = (DisplayName = "Read Gesture Database File to Buffer", ExpandEnumAsExecs = "Result"))
         static void readFileToBuffer(const FString& Path, GestureRecognition_Result& Result, TArray<uint8>& Data);
 
+    /**
+    * Get information about a gesture database (type, parts, gesture and combination names)
+    * without creating a GestureRecognitionActor or GestureCombinationsActor.
+    * The information is cached by content hash, so repeated calls for the same database are fast.
+    * @param Data The contents of the gesture database file.
+    * @param Result Result of the process.
+    * @param Info The information about the gesture database.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MiVRy Util", Meta = (DisplayName = "Peek Gesture Database", ExpandEnumAsExecs = "Result"))
+        static void peekDatabase(const TArray<uint8>& Data, GestureRecognition_Result& Result, FMiVRyDatabaseInfo& Info);
+
+    /**
+    * Get information about a gesture database file (type, parts, gesture and combination names)
+    * without creating a GestureRecognitionActor or GestureCombinationsActor.
+    * @param Path The file path of the gesture database file.
+    * @param Result Result of the process.
+    * @param Info The information about the gesture database.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MiVRy Util", Meta = (DisplayName = "Peek Gesture Database File", ExpandEnumAsExecs = "Result"))
+        static void peekDatabaseFile(const FString& Path, GestureRecognition_Result& Result, FMiVRyDatabaseInfo& Info);
+
+    /**
+    * Compress a gesture database (as created by "saveToFile") into the chunked MiVRy compressed format.
+    * Compressed gesture database files can be used with all "loadFromFile" and "readFileToBuffer" functions,
+    * they are decompressed chunk-by-chunk while being read.
+    * @param Data The (uncompressed) contents of a gesture database file.
+    * @param Result Result of the compression process.
+    * @param CompressedData The compressed gesture database.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MiVRy Util", Meta = (DisplayName = "Compress Gesture Database", ExpandEnumAsExecs = "Result"))
+        static void compressDatabase(const TArray<uint8>& Data, GestureRecognition_Result& Result, TArray<uint8>& CompressedData);
+
+    /**
+    * Compress a gesture database file (as created by "saveToFile") into a new, compressed gesture database file.
+    * @param SourcePath The file path of the (uncompressed) gesture database file.
+    * @param TargetPath The file path where to write the compressed gesture database file.
+    * @param Result Result of the compression process.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MiVRy Util", Meta = (DisplayName = "Compress Gesture Database File", ExpandEnumAsExecs = "Result"))
+        static void compressDatabaseFile(const FString& SourcePath, const FString& TargetPath, GestureRecognition_Result& Result);
+
+    /**
+    * Check whether a gesture database buffer is in the MiVRy compressed format.
+    * @param Data Pointer to the (beginning of the) gesture database.
+    * @param Size The number of bytes available in Data.
+    * @return True if the data is a compressed gesture database, false otherwise.
+    */
+    static bool isCompressedDatabase(const uint8* Data, int64 Size);
+
+    /**
+    * Check whether a gesture database file is in the MiVRy compressed format.
+    * Only the file header is read.
+    * @param Path The file path of the gesture database file.
+    * @return True if the file is a compressed gesture database, false otherwise.
+    */
+    static bool isCompressedDatabaseFile(const FString& Path);
+
+    /**
+    * Decompress a gesture database buffer in the MiVRy compressed format.
+    * @param Data The compressed gesture database.
+    * @param Size The number of bytes in Data.
+    * @param DecompressedData [OUT] The decompressed gesture database.
+    * @return True on success, false if the data is not a valid compressed gesture database.
+    */
+    static bool decompressDatabase(const uint8* Data, int64 Size, TArray<uint8>& DecompressedData);
+
     /**
     * Helper function to convert UnrealEngine coordinates to internal MiVRy coordinates (if they differ from Unreal coordinates).
     * @param location           The position in Unreal coordinates.
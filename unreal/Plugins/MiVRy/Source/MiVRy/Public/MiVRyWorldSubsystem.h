@@ -0,0 +1,81 @@
+/*
+ * MiVRy - VR gesture recognition library plug-in for Unreal.
+ * Version 2.12
+ * Copyright (c) 2025 MARUI-PlugIn (inc.)
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "MiVRyUtil.h"
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MiVRyWorldSubsystem.generated.h"
+
+class AMiVRyActor;
+
+/**
+* World subsystem which processes all MiVRy actors (with TickInWorldSubsystem enabled)
+* in one batch per frame: the poses of all actors are gathered on the game thread,
+* the gesture data of all actors is processed in parallel, and the identification results
+* are delivered on the game thread.
+*/
+UCLASS()
+class MIVRY_API UMiVRyWorldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override; //!< Called every frame.
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override; //!< Called when the world is torn down.
+
+	/**
+	* Add a MiVRy actor to be processed by this subsystem.
+	* The actor's own tick is disabled while it is registered.
+	* @param Actor The actor to process every frame.
+	*/
+	void registerActor(AMiVRyActor* Actor);
+
+	/**
+	* Stop processing a MiVRy actor (and re-enable its own tick).
+	* @param Actor The actor to remove.
+	*/
+	void unregisterActor(AMiVRyActor* Actor);
+
+	/**
+	* Load gesture database file into an array buffer (see UMiVRyUtil::readFileToBuffer).
+	* Files are shared (not copied) as long as they are in use, and at least until the end of the frame,
+	* so that several actors starting with the same gesture database only read (and decompress) it once.
+	* Files are read again when they were modified on disk.
+	* @param Path The file path from where to load the gesture database.
+	* @param Result Result of the loading process.
+	* @return The contents of the gesture database file, or null if it could not be read.
+	*/
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> readDatabaseFile(const FString& Path, GestureRecognition_Result& Result);
+
+private:
+	UPROPERTY()
+	TArray<AMiVRyActor*> Actors; //!< The registered MiVRy actors.
+
+	/**
+	* Gesture database file read by readDatabaseFile.
+	*/
+	struct DatabaseFile {
+		TWeakPtr<const TArray<uint8>, ESPMode::ThreadSafe> Data; //!< The file contents (while in use).
+		FDateTime TimeStamp; //!< Modification time of the file when it was read.
+	};
+	TMap<FString, DatabaseFile> DatabaseFiles; //!< Gesture database files read in this world, by path.
+	TArray<TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe>> FrameDatabaseFiles; //!< Keeps the files read during the current frame alive.
+};